@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include "chunkedlist/ChunkedList.h"
+#include "linkedlist/LinkedList.h"
+#include "simd/Scan.h"
+
+// Counterparts of the LinkedList scans in LinkedListBenchmarks.cpp, over the
+// same sizes, to compare against packing a cache line of elements per node.
+
+static ChunkedList<int> MakeChunkedList(const int n) {
+  ChunkedList<int> list;
+  for (int i = n - 1; i >= 0; i--) list = list.Cons(i);
+  return list;
+}
+
+static void BM_ChunkedListCons(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto list = ChunkedList<int>::Empty();
+    for (int i = 0; i < n; i++) list = list.Cons(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListCons)->Range(1 << 6, 1 << 16);
+
+static void BM_ChunkedListIndex(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(list.Index(n - 1));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListIndex)->Range(1 << 6, 1 << 16);
+
+static void BM_ChunkedListIterate(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) {
+    long sum = 0;  // NOLINT(google-runtime-int)
+    for (const int element : list) sum += element;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListIterate)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListLast(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < n; i++) builder.Snoc(i);
+  const auto list = builder.Build();
+  for (auto _ : state) benchmark::DoNotOptimize(list.Last());
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListLast)->Range(1 << 6, 1 << 16);
+
+static void BM_ChunkedListLast(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(list.Last());
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListLast)->Range(1 << 6, 1 << 16);
+
+static void BM_ChunkedListReverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(Reverse(list));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListReverse)->Range(1 << 6, 1 << 16);
+
+// Sum and Find through the per-node kernels of simd/Scan.h, against
+// BM_ChunkedListIterate's element-at-a-time loop.
+static void BM_ChunkedListSum(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(Sum(list));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListSum)->Range(1 << 6, 1 << 16);
+
+static void BM_ChunkedListFind(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeChunkedList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(Find(list, n - 1));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ChunkedListFind)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "atomicref/AtomicRef.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+// One writer publishes versions while the benchmark's threads, 1 to 64 of
+// them, read: each iteration loads the current version, traverses it and
+// drops it. Reported:
+// - items_per_second: elements traversed, summed over readers.
+// - p50_ns, p99_ns: latency of one load-traverse-drop, the percentiles of
+//   each reader averaged over readers.
+// - publishes: versions the writer published per second.
+// LocalSharing cannot be shared between threads, so IntrusiveSharing stands
+// in for the cheaper counts; the non-atomic policy is measured single-
+// threaded in SharingBenchmarks.cpp.
+
+constexpr int kLength = 1 << 10;
+
+// A std::mutex around the current version, as the baseline for AtomicRef's
+// lock-free root.
+template <typename X>
+class MutexRef {
+  mutable std::mutex mutex_;
+  X value_ = X::Empty();
+
+ public:
+  X Load() const {
+    std::lock_guard lock(mutex_);
+    return value_;
+  }
+  void Store(X value) {
+    std::lock_guard lock(mutex_);
+    value_ = std::move(value);
+  }
+};
+
+// Deque versions sliding along a window of kLength elements: each Snocs one
+// element and drops one from the front. Readers iterate, so they touch only
+// the counts of the version they load.
+template <typename Sharing, template <typename> typename Ref = AtomicRef>
+struct SlidingDeque {
+  using X = Deque<int, std::allocator<int>, Sharing>;
+  using Root = Ref<X>;
+
+  static X Initial() {
+    auto deque = X::Empty();
+    for (int i = 0; i < kLength; i++) deque = deque.Snoc(i);
+    return deque;
+  }
+  static X Next(const X& version, const int i) {
+    return version.Snoc(i).Tail();
+  }
+  static long Walk(const X& version) {  // NOLINT(google-runtime-int)
+    long sum = 0;                       // NOLINT(google-runtime-int)
+    for (const int element : version.Elements()) sum += element;
+    return sum;
+  }
+};
+
+// List versions that each put one new head on the same tail of kLength - 1
+// nodes. Readers that walk with Tail() copy a reference to every node of
+// the tail, so they all write the same count cache lines. kCounted false
+// walks through iterators instead, which touches none of them: the
+// difference is the cost of contention on shared tails.
+template <typename Sharing, bool kCounted>
+struct SharedTailList {
+  using X = LinkedList<int, std::allocator<int>, Sharing>;
+  using Root = AtomicRef<X>;
+
+  static const X& Tail() {
+    static const X tail = [] {
+      typename X::Builder builder;
+      for (int i = 1; i < kLength; i++) builder.Snoc(i);
+      return builder.Build();
+    }();
+    return tail;
+  }
+  static X Initial() { return Tail().Cons(0); }
+  static X Next(const X& /*version*/, const int i) { return Tail().Cons(i); }
+  static long Walk(const X& version) {  // NOLINT(google-runtime-int)
+    long sum = 0;                       // NOLINT(google-runtime-int)
+    if constexpr (kCounted) {
+      for (X cur = version; !cur.IsEmpty(); cur = cur.Tail()) sum += cur.Head();
+    } else {
+      for (const int element : version) sum += element;
+    }
+    return sum;
+  }
+};
+
+// Publishes Fixture versions to root on its own thread until stopped.
+template <typename Fixture>
+class BackgroundWriter {
+  typename Fixture::Root& root_;
+  std::atomic<bool> stop_ = false;
+  std::int64_t published_ = 0;
+  std::thread thread_;
+
+ public:
+  explicit BackgroundWriter(typename Fixture::Root& root)
+      : root_(root), thread_([this] {
+          auto version = root_.Load();
+          for (int i = 0; !stop_.load(std::memory_order_relaxed); i++) {
+            version = Fixture::Next(version, i);
+            root_.Store(version);
+            published_++;
+          }
+        }) {}
+
+  // Returns the number of versions published.
+  std::int64_t Stop() {
+    stop_ = true;
+    thread_.join();
+    return published_;
+  }
+};
+
+static double Percentile(std::vector<std::int64_t>& samples, const double q) {
+  if (samples.empty()) return 0;
+  const auto nth =
+      samples.begin() + static_cast<std::ptrdiff_t>((samples.size() - 1) * q);
+  std::nth_element(samples.begin(), nth, samples.end());
+  return static_cast<double>(*nth);
+}
+
+template <typename Fixture>
+static void BM_ConcurrentReaders(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  static typename Fixture::Root root;
+  static std::unique_ptr<BackgroundWriter<Fixture>> writer;
+  // Nothing reads before every thread reaches the loop, and the loop ends
+  // only once every thread is done, so thread 0 can set up and tear down.
+  if (state.thread_index() == 0) {
+    root.Store(Fixture::Initial());
+    writer = std::make_unique<BackgroundWriter<Fixture>>(root);
+  }
+
+  std::vector<std::int64_t> latencies;
+  for (auto _ : state) {
+    const Clock::time_point start = Clock::now();
+    benchmark::DoNotOptimize(Fixture::Walk(root.Load()));
+    latencies.push_back((Clock::now() - start).count());
+  }
+  state.SetItemsProcessed(state.iterations() * kLength);
+  state.counters["p50_ns"] = benchmark::Counter(
+      Percentile(latencies, 0.5), benchmark::Counter::kAvgThreads);
+  state.counters["p99_ns"] = benchmark::Counter(
+      Percentile(latencies, 0.99), benchmark::Counter::kAvgThreads);
+
+  if (state.thread_index() == 0) {
+    state.counters["publishes"] = benchmark::Counter(
+        static_cast<double>(writer->Stop()), benchmark::Counter::kIsRate);
+    writer.reset();
+    root.Store(Fixture::X::Empty());
+  }
+}
+BENCHMARK(BM_ConcurrentReaders<SlidingDeque<AtomicSharing>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentReaders<SlidingDeque<IntrusiveSharing>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentReaders<SlidingDeque<AtomicSharing, MutexRef>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentReaders<SharedTailList<AtomicSharing, true>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentReaders<SharedTailList<IntrusiveSharing, true>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentReaders<SharedTailList<AtomicSharing, false>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
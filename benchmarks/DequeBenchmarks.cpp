@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <vector>
+
+#include "atomicref/AtomicRef.h"
+#include "deque/Deque.h"
+#include "deque/RealTimeDeque.h"
+#include "fingertree/FingerTree.h"
+#include "stream/StreamPublisher.h"
+
+template <typename D>
+static D MakeDeque(const int n) {
+  auto deque = D::Empty();
+  for (int i = 0; i < n; i++) deque = deque.Snoc(i);
+  return deque;
+}
+
+template <typename D>
+static void BM_Snoc(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(MakeDeque<D>(n));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Snoc<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_Snoc<RealTimeDeque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_Snoc<FingerTree<int>>)->Range(1 << 6, 1 << 16);
+
+// Ingest as BM_Snoc<Deque<int>> does, publishing a snapshot every 1024
+// elements along the way.
+static void BM_StreamPublisher(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    AtomicRef<Deque<int>> ref;
+    StreamPublisher<Deque<int>> publisher(ref);
+    for (int i = 0; i < n; i++) publisher.Push(i);
+    benchmark::DoNotOptimize(publisher.Finish());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StreamPublisher)->Range(1 << 6, 1 << 16);
+
+static void BM_StdDequePushBack(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::deque<int> deque;
+    for (int i = 0; i < n; i++) deque.push_back(i);
+    benchmark::DoNotOptimize(deque);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StdDequePushBack)->Range(1 << 6, 1 << 16);
+
+// Queue usage: push at the back, pop at the front, until everything that was
+// pushed has been drained.
+template <typename D>
+static void BM_QueueMix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto deque = D::Empty();
+    for (int i = 0; i < n; i++) {
+      deque = deque.Snoc(i).Snoc(i);
+      benchmark::DoNotOptimize(deque.Head());
+      deque = deque.Tail();
+    }
+    while (!deque.IsEmpty()) deque = deque.Tail();
+    benchmark::DoNotOptimize(deque);
+  }
+  state.SetItemsProcessed(state.iterations() * n * 2);
+}
+BENCHMARK(BM_QueueMix<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_QueueMix<RealTimeDeque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_QueueMix<FingerTree<int>>)->Range(1 << 6, 1 << 16);
+
+static void BM_StdDequeQueueMix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::deque<int> deque;
+    for (int i = 0; i < n; i++) {
+      deque.push_back(i);
+      deque.push_back(i);
+      benchmark::DoNotOptimize(deque.front());
+      deque.pop_front();
+    }
+    while (!deque.empty()) deque.pop_front();
+    benchmark::DoNotOptimize(deque);
+  }
+  state.SetItemsProcessed(state.iterations() * n * 2);
+}
+BENCHMARK(BM_StdDequeQueueMix)->Range(1 << 6, 1 << 16);
+
+// Pops from both ends alternately, which forces Deque to rebalance often.
+template <typename D>
+static void BM_AlternatingPops(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto full = MakeDeque<D>(n);
+  for (auto _ : state) {
+    auto deque = full;
+    for (bool front = true; !deque.IsEmpty(); front = !front)
+      deque = front ? deque.Tail() : deque.Init();
+    benchmark::DoNotOptimize(deque);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_AlternatingPops<Deque<int>>)->Range(1 << 6, 1 << 14);
+BENCHMARK(BM_AlternatingPops<RealTimeDeque<int>>)->Range(1 << 6, 1 << 14);
+BENCHMARK(BM_AlternatingPops<FingerTree<int>>)->Range(1 << 6, 1 << 14);
+
+// As above, but the deque owns its nodes and is consumed by each pop, so the
+// rebalances relink nodes instead of copying them.
+static void BM_ConsumingAlternatingPops(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto deque = MakeDeque<Deque<int>>(n);
+    state.ResumeTiming();
+    for (bool front = true; !deque.IsEmpty(); front = !front)
+      deque = front ? std::move(deque).Tail() : std::move(deque).Init();
+    benchmark::DoNotOptimize(deque);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ConsumingAlternatingPops)->Range(1 << 6, 1 << 14);
+
+// Persistent fork: keep replaying the same operation on one old version.
+// For Deque the version is chosen so that every Tail has to rebalance: after
+// n Snocs its front list holds a single element.
+template <typename D>
+static void BM_ReplayOldVersion(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto old_version = MakeDeque<D>(n);
+  for (auto _ : state) benchmark::DoNotOptimize(old_version.Tail());
+}
+BENCHMARK(BM_ReplayOldVersion<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_ReplayOldVersion<RealTimeDeque<int>>)->Range(1 << 6, 1 << 16);
+
+template <typename D>
+static void BM_Index(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto deque = MakeDeque<D>(n).Tail();
+  for (auto _ : state) benchmark::DoNotOptimize(deque.Index(n / 3));
+}
+BENCHMARK(BM_Index<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_Index<FingerTree<int>>)->Range(1 << 6, 1 << 16);
+
+template <typename D>
+static void BM_Append(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto front = MakeDeque<D>(n);
+  const auto back = MakeDeque<D>(n);
+  for (auto _ : state) benchmark::DoNotOptimize(front.Append(back));
+  state.SetItemsProcessed(state.iterations() * n * 2);
+}
+BENCHMARK(BM_Append<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_Append<FingerTree<int>>)->Range(1 << 6, 1 << 16);
+
+// Merging a small batch into a large structure, from either side.
+template <typename D>
+static void BM_AppendSmall(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto large = MakeDeque<D>(n);
+  const auto small = MakeDeque<D>(16);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(large.Append(small));
+    benchmark::DoNotOptimize(small.Append(large));
+  }
+}
+BENCHMARK(BM_AppendSmall<Deque<int>>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_AppendSmall<FingerTree<int>>)->Range(1 << 6, 1 << 16);
+
+static void BM_FingerTreeSplitAt(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto tree = MakeDeque<FingerTree<int>>(n);
+  for (auto _ : state) benchmark::DoNotOptimize(tree.SplitAt(n / 3));
+}
+BENCHMARK(BM_FingerTreeSplitAt)->Range(1 << 6, 1 << 16);
+
+static void BM_DequeIterate(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto deque = MakeDeque<Deque<int>>(n).Tail();
+  for (auto _ : state) {
+    long sum = 0;  // NOLINT(google-runtime-int)
+    for (const int element : deque.Elements()) sum += element;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_DequeIterate)->Range(1 << 6, 1 << 16);
+
+// Drain a queue in batches of state.range(0), with one Tail per element or
+// one DropFront per batch.
+static void BM_DrainBatchTail(benchmark::State& state) {
+  const int batch = static_cast<int>(state.range(0));
+  const auto deque = MakeDeque<Deque<int>>(1 << 16);
+  for (auto _ : state) {
+    auto rest = deque;
+    while (rest.Length() >= batch)
+      for (int i = 0; i < batch; i++) rest = rest.Tail();
+    benchmark::DoNotOptimize(rest);
+  }
+  state.SetItemsProcessed(state.iterations() * (1 << 16));
+}
+BENCHMARK(BM_DrainBatchTail)->Range(1 << 6, 1 << 10);
+
+static void BM_DrainBatchDropFront(benchmark::State& state) {
+  const int batch = static_cast<int>(state.range(0));
+  const auto deque = MakeDeque<Deque<int>>(1 << 16);
+  for (auto _ : state) {
+    auto rest = deque;
+    while (rest.Length() >= batch) rest = rest.DropFront(batch);
+    benchmark::DoNotOptimize(rest);
+  }
+  state.SetItemsProcessed(state.iterations() * (1 << 16));
+}
+BENCHMARK(BM_DrainBatchDropFront)->Range(1 << 6, 1 << 10);
+
+static void BM_SnocRange(benchmark::State& state) {
+  const int batch = static_cast<int>(state.range(0));
+  std::vector<int> elements(batch);
+  const auto deque = MakeDeque<Deque<int>>(1 << 10);
+  for (auto _ : state) benchmark::DoNotOptimize(deque.SnocRange(elements));
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_SnocRange)->Range(1 << 6, 1 << 10);
@@ -0,0 +1,150 @@
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <vector>
+
+#include "Utils.h"
+#include "linkedlist/LinkedList.h"
+
+// Helper to build [0, n) with the transient builder.
+static LinkedList<int> MakeList(const int n) {
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < n; i++) builder.Snoc(i);
+  return builder.Build();
+}
+
+static void BM_LinkedListCons(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto list = LinkedList<int>::Empty();
+    for (int i = 0; i < n; i++) list = list.Cons(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListCons)->Range(1 << 6, 1 << 16);
+
+static void BM_StdListPushFront(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::list<int> list;
+    for (int i = 0; i < n; i++) list.push_front(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StdListPushFront)->Range(1 << 6, 1 << 16);
+
+static void BM_StdVectorPushBack(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> vector;
+    for (int i = 0; i < n; i++) vector.push_back(i);
+    benchmark::DoNotOptimize(vector);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StdVectorPushBack)->Range(1 << 6, 1 << 16);
+
+// Repeated Snoc is quadratic, so keep the sizes small.
+static void BM_LinkedListSnoc(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto list = LinkedList<int>::Empty();
+    for (int i = 0; i < n; i++) list = list.Snoc(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListSnoc)->Range(1 << 4, 1 << 10);
+
+// Still quadratic, but relinks the existing nodes instead of copying them.
+static void BM_LinkedListConsumingSnoc(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto list = LinkedList<int>::Empty();
+    for (int i = 0; i < n; i++) list = std::move(list).Snoc(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListConsumingSnoc)->Range(1 << 4, 1 << 10);
+
+static void BM_LinkedListBuilder(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(MakeList(n));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListBuilder)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListAppend(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto front = MakeList(n);
+  const auto back = MakeList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(front.Append(back));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListAppend)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListIndex(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(list.Index(n / 2));
+}
+BENCHMARK(BM_LinkedListIndex)->Range(1 << 6, 1 << 16);
+
+static void BM_StdVectorIndex(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  std::vector<int> vector(n);
+  for (auto _ : state) benchmark::DoNotOptimize(vector[n / 2]);
+}
+BENCHMARK(BM_StdVectorIndex)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListIterate(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList(n);
+  for (auto _ : state) {
+    long sum = 0;  // NOLINT(google-runtime-int)
+    for (const int element : list) sum += element;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListIterate)->Range(1 << 6, 1 << 16);
+
+static void BM_StdListIterate(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  std::list<int> list;
+  for (int i = 0; i < n; i++) list.push_back(i);
+  for (auto _ : state) {
+    long sum = 0;  // NOLINT(google-runtime-int)
+    for (const int element : list) sum += element;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StdListIterate)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListReverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(Reverse(list));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListReverse)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListSplitAt(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(SplitAt(n / 2, list));
+  state.SetItemsProcessed(state.iterations() * n / 2);
+}
+BENCHMARK(BM_LinkedListSplitAt)->Range(1 << 6, 1 << 16);
+
+static void BM_LinkedListSplitAndReverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList(n);
+  for (auto _ : state) benchmark::DoNotOptimize(SplitAndReverse(n / 2, list));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinkedListSplitAndReverse)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "Utils.h"
+#include "allocator/PoolAllocator.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+template <typename List>
+static List MakeList(const int n) {
+  typename List::Builder builder;
+  for (int i = 0; i < n; i++) builder.Snoc(i);
+  return builder.Build();
+}
+
+using AtomicList = LinkedList<int>;
+using LocalList = LinkedList<int, std::allocator<int>, LocalSharing>;
+using IntrusiveList = LinkedList<int, std::allocator<int>, IntrusiveSharing>;
+using PooledList = LinkedList<int, PoolAllocator<int>>;
+
+// Walks with Tail(), copying a reference for every node, which is where the
+// sharing policy shows up.
+template <typename List>
+static void BM_TailWalk(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList<List>(n);
+  for (auto _ : state) {
+    for (List cur = list; !cur.IsEmpty(); cur = cur.Tail())
+      benchmark::DoNotOptimize(cur.Head());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TailWalk<AtomicList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_TailWalk<LocalList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_TailWalk<IntrusiveList>)->Range(1 << 6, 1 << 16);
+
+template <typename List>
+static void BM_PolicyReverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const auto list = MakeList<List>(n);
+  for (auto _ : state) benchmark::DoNotOptimize(Reverse(list));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PolicyReverse<AtomicList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyReverse<LocalList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyReverse<IntrusiveList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyReverse<PooledList>)->Range(1 << 6, 1 << 16);
+
+template <typename List>
+static void BM_PolicyCons(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto list = List::Empty();
+    for (int i = 0; i < n; i++) list = list.Cons(i);
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PolicyCons<AtomicList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyCons<LocalList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyCons<IntrusiveList>)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_PolicyCons<PooledList>)->Range(1 << 6, 1 << 16);
+
+// Every thread walks the same shared list with Tail(), so all of them hammer
+// the same reference counts.
+static void BM_SharedListTailWalk(benchmark::State& state) {
+  static AtomicList shared;
+  constexpr int kLength = 1 << 12;
+  if (state.thread_index() == 0) shared = MakeList<AtomicList>(kLength);
+  for (auto _ : state) {
+    for (AtomicList cur = shared; !cur.IsEmpty(); cur = cur.Tail())
+      benchmark::DoNotOptimize(cur.Head());
+  }
+  state.SetItemsProcessed(state.iterations() * kLength);
+  if (state.thread_index() == 0) shared = AtomicList();
+}
+BENCHMARK(BM_SharedListTailWalk)->ThreadRange(1, 8)->UseRealTime();
+
+// The same traversal through iterators touches no reference counts.
+static void BM_SharedListIterate(benchmark::State& state) {
+  static AtomicList shared;
+  constexpr int kLength = 1 << 12;
+  if (state.thread_index() == 0) shared = MakeList<AtomicList>(kLength);
+  for (auto _ : state) {
+    long sum = 0;  // NOLINT(google-runtime-int)
+    for (const int element : shared) sum += element;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kLength);
+  if (state.thread_index() == 0) shared = AtomicList();
+}
+BENCHMARK(BM_SharedListIterate)->ThreadRange(1, 8)->UseRealTime();
+
+// Each thread forks its own versions off a shared base deque.
+static void BM_SharedDequeForks(benchmark::State& state) {
+  static Deque<int> base = Deque<int>::Empty();
+  constexpr int kLength = 1 << 12;
+  if (state.thread_index() == 0) {
+    base = Deque<int>::Empty();
+    for (int i = 0; i < kLength; i++) base = base.Snoc(i);
+  }
+  for (auto _ : state) {
+    auto fork = base.Cons(-1).Snoc(-1).Tail().Init();
+    benchmark::DoNotOptimize(fork);
+  }
+  if (state.thread_index() == 0) base = Deque<int>::Empty();
+}
+BENCHMARK(BM_SharedDequeForks)->ThreadRange(1, 8)->UseRealTime();
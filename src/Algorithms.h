@@ -0,0 +1,327 @@
+#ifndef ALGORITHMS_H
+#define ALGORITHMS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+// Higher-order operations over LinkedList and Deque: Map, Filter, FoldLeft,
+// Reduce and ForEach. As with SplitAt, the structure is the last argument.
+//
+// Map, Filter, Reduce and ForEach also take a std::execution policy. With
+// std::execution::par or par_unseq the input is cut into one contiguous
+// chunk per hardware thread (see SetParallelThreads), using the cached
+// Length() to size the chunks.
+// Each chunk is processed on its own thread into its own LinkedList builder,
+// and the builders are spliced together in O(1) each, so no result element
+// is copied after it is built. seq and unseq run on the calling thread.
+//
+// The worker threads read the input through raw-pointer iterators and never
+// touch its reference counts. The result is assembled on the calling
+// thread. Inputs that use LocalSharing are therefore fine, provided the
+// function itself does not copy them.
+//
+// Under a parallel policy the function may run concurrently on different
+// elements. Reduce also needs the operation to be associative. If the
+// function throws, every chunk still runs to completion before the first
+// exception is rethrown.
+
+// Chunks smaller than this are not worth a thread of their own.
+inline constexpr int kMinParallelChunk = 4096;
+
+inline std::atomic<int>& ParallelThreadsOverride() {
+  static std::atomic<int> threads = 0;
+  return threads;
+}
+
+// Cap on the threads a parallel overload uses. 0, the default, means
+// std::thread::hardware_concurrency().
+inline void SetParallelThreads(const int threads) {
+  ParallelThreadsOverride().store(threads, std::memory_order_relaxed);
+}
+
+inline int ParallelThreads() {
+  const int threads = ParallelThreadsOverride().load(std::memory_order_relaxed);
+  if (threads > 0) return threads;
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+template <typename Policy>
+concept ExecutionPolicy =
+    std::is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+template <typename Policy>
+inline constexpr bool kIsParallelPolicy =
+    std::is_same_v<std::remove_cvref_t<Policy>,
+                   std::execution::parallel_policy> ||
+    std::is_same_v<std::remove_cvref_t<Policy>,
+                   std::execution::parallel_unsequenced_policy>;
+
+// Number of chunks to cut length elements into under Policy. Always at least
+// one, so that callers can splice the results into the first chunk's.
+template <typename Policy>
+int ChunkCount(const int length) {
+  if constexpr (!kIsParallelPolicy<Policy>) {
+    return 1;
+  } else {
+    return std::clamp(length / kMinParallelChunk, 1, ParallelThreads());
+  }
+}
+
+// Call body(chunk, begin, count) for chunks contiguous runs of the length
+// elements starting at first. Every chunk but the last gets a thread, and
+// the last runs on the calling thread while the others are walked to.
+template <typename It, typename Body>
+void RunChunks(It first, const int length, const int chunks, Body& body) {
+  if (chunks == 1) {
+    body(0, first, length);
+    return;
+  }
+  std::vector<std::exception_ptr> errors(chunks);
+  auto run = [&body, &errors](const int chunk, It begin, const int count) {
+    try {
+      body(chunk, begin, count);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(chunks - 1);
+    for (int chunk = 0; chunk < chunks; chunk++) {
+      const int count = length / chunks + (chunk < length % chunks ? 1 : 0);
+      if (chunk == chunks - 1) {
+        run(chunk, first, count);
+      } else {
+        threads.emplace_back(run, chunk, first, count);
+        std::advance(first, count);
+      }
+    }
+  }
+  for (const std::exception_ptr& error : errors)
+    if (error) std::rethrow_exception(error);
+}
+
+// Run fill(builder, begin, count) for every chunk and splice the builders
+// into one list, in chunk order.
+template <typename Policy, typename List, typename It, typename Fill>
+List BuildChunks(It first, const int length, Fill fill) {
+  const int chunks = ChunkCount<Policy>(length);
+  std::vector<typename List::Builder> parts(chunks);
+  auto body = [&parts, &fill](const int chunk, It begin, const int count) {
+    fill(parts[chunk], begin, count);
+  };
+  RunChunks(first, length, chunks, body);
+  for (int i = 1; i < chunks; i++) parts[0].Append(std::move(parts[i]));
+  return parts[0].Build();
+}
+
+template <typename Fn, typename T>
+using MappedType = std::decay_t<std::invoke_result_t<Fn&, const T&>>;
+
+template <typename Alloc, typename U>
+using ReboundAlloc =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+// List of Us with the allocator and sharing policy of a list of Ts.
+template <typename U, typename Alloc, typename Sharing>
+using ReboundList = LinkedList<U, ReboundAlloc<Alloc, U>, Sharing>;
+
+template <typename Policy, typename List, typename It, typename Fn>
+List MapChunks(It first, const int length, Fn& fn) {
+  return BuildChunks<Policy, List>(
+      first, length,
+      [&fn](typename List::Builder& builder, It begin, int count) {
+        for (; count > 0; --count, ++begin)
+          builder.Snoc(std::invoke(fn, *begin));
+      });
+}
+
+template <typename Policy, typename List, typename It, typename Pred>
+List FilterChunks(It first, const int length, Pred& pred) {
+  return BuildChunks<Policy, List>(
+      first, length,
+      [&pred](typename List::Builder& builder, It begin, int count) {
+        for (; count > 0; --count, ++begin)
+          if (std::invoke(pred, *begin)) builder.Snoc(*begin);
+      });
+}
+
+template <typename Policy, typename It, typename Fn, typename Acc>
+Acc ReduceChunks(It first, const int length, Fn& fn, Acc init) {
+  const int chunks = ChunkCount<Policy>(length);
+  std::vector<std::optional<Acc>> partials(chunks);
+  auto body = [&partials, &fn](const int chunk, It begin, int count) {
+    if (count == 0) return;
+    Acc acc(*begin);
+    for (++begin, --count; count > 0; --count, ++begin)
+      acc = std::invoke(fn, std::move(acc), *begin);
+    partials[chunk].emplace(std::move(acc));
+  };
+  RunChunks(first, length, chunks, body);
+  for (std::optional<Acc>& partial : partials)
+    if (partial.has_value())
+      init = std::invoke(fn, std::move(init), std::move(*partial));
+  return init;
+}
+
+template <typename Policy, typename It, typename Fn>
+void ForEachChunks(It first, const int length, Fn& fn) {
+  auto body = [&fn](int /*chunk*/, It begin, int count) {
+    for (; count > 0; --count, ++begin) std::invoke(fn, *begin);
+  };
+  RunChunks(first, length, ChunkCount<Policy>(length), body);
+}
+
+// Map: the list of fn(x) for every element x, in order.
+template <ExecutionPolicy Policy, typename Fn, typename T, typename Alloc,
+          typename Sharing>
+auto Map(Policy&& /*policy*/, Fn fn, const LinkedList<T, Alloc, Sharing>& list)
+    -> ReboundList<MappedType<Fn, T>, Alloc, Sharing> {
+  using Result = ReboundList<MappedType<Fn, T>, Alloc, Sharing>;
+  return MapChunks<Policy, Result>(list.begin(), list.Length(), fn);
+}
+
+template <typename Fn, typename T, typename Alloc, typename Sharing>
+auto Map(Fn fn, const LinkedList<T, Alloc, Sharing>& list) {
+  return Map(std::execution::seq, std::move(fn), list);
+}
+
+// Filter: the elements satisfying pred, in order.
+template <ExecutionPolicy Policy, typename Pred, typename T, typename Alloc,
+          typename Sharing>
+LinkedList<T, Alloc, Sharing> Filter(
+    Policy&& /*policy*/, Pred pred, const LinkedList<T, Alloc, Sharing>& list) {
+  return FilterChunks<Policy, LinkedList<T, Alloc, Sharing>>(
+      list.begin(), list.Length(), pred);
+}
+
+template <typename Pred, typename T, typename Alloc, typename Sharing>
+LinkedList<T, Alloc, Sharing> Filter(
+    Pred pred, const LinkedList<T, Alloc, Sharing>& list) {
+  return Filter(std::execution::seq, std::move(pred), list);
+}
+
+// FoldLeft: fn(...fn(fn(init, x0), x1)..., xn-1). Inherently sequential.
+template <typename Fn, typename Acc, typename T, typename Alloc,
+          typename Sharing>
+Acc FoldLeft(Fn fn, Acc init, const LinkedList<T, Alloc, Sharing>& list) {
+  for (const T& element : list)
+    init = std::invoke(fn, std::move(init), element);
+  return init;
+}
+
+// Reduce: combine init and every element with the associative fn. A
+// parallel policy reduces each chunk separately and then combines the
+// partial results in order.
+template <ExecutionPolicy Policy, typename Fn, typename Acc, typename T,
+          typename Alloc, typename Sharing>
+Acc Reduce(Policy&& /*policy*/, Fn fn, Acc init,
+           const LinkedList<T, Alloc, Sharing>& list) {
+  return ReduceChunks<Policy>(list.begin(), list.Length(), fn,
+                              std::move(init));
+}
+
+template <typename Fn, typename Acc, typename T, typename Alloc,
+          typename Sharing>
+Acc Reduce(Fn fn, Acc init, const LinkedList<T, Alloc, Sharing>& list) {
+  return Reduce(std::execution::seq, std::move(fn), std::move(init), list);
+}
+
+// ForEach: call fn on every element, in order unless the policy is
+// parallel.
+template <ExecutionPolicy Policy, typename Fn, typename T, typename Alloc,
+          typename Sharing>
+void ForEach(Policy&& /*policy*/, Fn fn,
+             const LinkedList<T, Alloc, Sharing>& list) {
+  ForEachChunks<Policy>(list.begin(), list.Length(), fn);
+}
+
+template <typename Fn, typename T, typename Alloc, typename Sharing>
+void ForEach(Fn fn, const LinkedList<T, Alloc, Sharing>& list) {
+  ForEach(std::execution::seq, std::move(fn), list);
+}
+
+// Deque overloads. They walk Elements(), and results are built as lists and
+// split into balanced deques with Deque::FromList.
+
+template <ExecutionPolicy Policy, typename Fn, typename T, typename Alloc,
+          typename Sharing>
+auto Map(Policy&& /*policy*/, Fn fn, const Deque<T, Alloc, Sharing>& deque) {
+  using U = MappedType<Fn, T>;
+  using List = ReboundList<U, Alloc, Sharing>;
+  const auto elements = deque.Elements();
+  return Deque<U, ReboundAlloc<Alloc, U>, Sharing>::FromList(
+      MapChunks<Policy, List>(elements.begin(), deque.Length(), fn));
+}
+
+template <typename Fn, typename T, typename Alloc, typename Sharing>
+auto Map(Fn fn, const Deque<T, Alloc, Sharing>& deque) {
+  return Map(std::execution::seq, std::move(fn), deque);
+}
+
+template <ExecutionPolicy Policy, typename Pred, typename T, typename Alloc,
+          typename Sharing>
+Deque<T, Alloc, Sharing> Filter(Policy&& /*policy*/, Pred pred,
+                                const Deque<T, Alloc, Sharing>& deque) {
+  const auto elements = deque.Elements();
+  return Deque<T, Alloc, Sharing>::FromList(
+      FilterChunks<Policy, LinkedList<T, Alloc, Sharing>>(
+          elements.begin(), deque.Length(), pred));
+}
+
+template <typename Pred, typename T, typename Alloc, typename Sharing>
+Deque<T, Alloc, Sharing> Filter(Pred pred,
+                                const Deque<T, Alloc, Sharing>& deque) {
+  return Filter(std::execution::seq, std::move(pred), deque);
+}
+
+template <typename Fn, typename Acc, typename T, typename Alloc,
+          typename Sharing>
+Acc FoldLeft(Fn fn, Acc init, const Deque<T, Alloc, Sharing>& deque) {
+  for (const T& element : deque.Elements())
+    init = std::invoke(fn, std::move(init), element);
+  return init;
+}
+
+template <ExecutionPolicy Policy, typename Fn, typename Acc, typename T,
+          typename Alloc, typename Sharing>
+Acc Reduce(Policy&& /*policy*/, Fn fn, Acc init,
+           const Deque<T, Alloc, Sharing>& deque) {
+  const auto elements = deque.Elements();
+  return ReduceChunks<Policy>(elements.begin(), deque.Length(), fn,
+                              std::move(init));
+}
+
+template <typename Fn, typename Acc, typename T, typename Alloc,
+          typename Sharing>
+Acc Reduce(Fn fn, Acc init, const Deque<T, Alloc, Sharing>& deque) {
+  return Reduce(std::execution::seq, std::move(fn), std::move(init), deque);
+}
+
+template <ExecutionPolicy Policy, typename Fn, typename T, typename Alloc,
+          typename Sharing>
+void ForEach(Policy&& /*policy*/, Fn fn,
+             const Deque<T, Alloc, Sharing>& deque) {
+  const auto elements = deque.Elements();
+  ForEachChunks<Policy>(elements.begin(), deque.Length(), fn);
+}
+
+template <typename Fn, typename T, typename Alloc, typename Sharing>
+void ForEach(Fn fn, const Deque<T, Alloc, Sharing>& deque) {
+  ForEach(std::execution::seq, std::move(fn), deque);
+}
+
+#endif  // ALGORITHMS_H
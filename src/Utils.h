@@ -4,26 +4,99 @@
 #include <stdexcept>
 #include <utility>
 
+#include "instrumentation/Instrumentation.h"
 #include "linkedlist/LinkedList.h"
 
-template <typename T>
-std::pair<LinkedList<T>, LinkedList<T>> SplitAt(const int n,
-                                                LinkedList<T> list) {
-  if (n < 0) throw std::out_of_range("Invalid split Index");
+// Split list into its first n elements and the rest. Iterative and single
+// pass: the prefix is copied with one allocation per node, getting its cached
+// sizes as it goes, and the suffix is shared with list. Nodes that list
+// solely owns are relinked into the prefix instead of being copied. Throws
+// std::out_of_range unless 0 <= n <= list.Length().
+template <typename T, typename Alloc, typename Sharing>
+std::pair<LinkedList<T, Alloc, Sharing>, LinkedList<T, Alloc, Sharing>> SplitAt(
+    const int n, LinkedList<T, Alloc, Sharing> list) {
+  using List = LinkedList<T, Alloc, Sharing>;
+  using Node = typename List::Node;
+  if (n < 0 || n > list.Length())
+    throw std::out_of_range("Invalid split Index");
 
-  if (n == 0) return std::make_pair(LinkedList<T>::Empty(), list);
+  typename List::Chain prefix;
+  int remaining = n;
+  while (remaining > 0 && list.OwnsHead()) {
+    auto node = list.TakeHead();
+    node->size_ = remaining--;
+    prefix.Link(std::move(node));
+  }
+  CountNodesCopied(remaining);
+  // From here on every node is shared, so walk raw pointers and take a single
+  // reference to the suffix at the end.
+  if (remaining > 0) {
+    Node* cur = list.value_.get();
+    for (; remaining > 1; cur = cur->next_.value_.get())
+      prefix.Link(List::MakeNode(cur->value_, List(), remaining--));
+    prefix.Link(List::MakeNode(cur->value_, List(), remaining--));
+    list = List(cur->next_);
+  }
+  return std::make_pair(prefix.Release(List()), std::move(list));
+}
 
-  const auto& [listA, listB] = SplitAt(n - 1, list.Tail());
-  return std::make_pair(listA.Cons(list.Head()), listB);
+// Fused SplitAt followed by Reverse of the suffix, which is how Deque turns
+// one list into its front and back halves. Returns the first n elements in
+// order and the remaining elements reversed, in a single pass with one
+// allocation per shared element; nodes that list solely owns are relinked.
+// Throws std::out_of_range unless 0 <= n <= list.Length().
+template <typename T, typename Alloc, typename Sharing>
+std::pair<LinkedList<T, Alloc, Sharing>, LinkedList<T, Alloc, Sharing>>
+SplitAndReverse(const int n, LinkedList<T, Alloc, Sharing> list) {
+  using List = LinkedList<T, Alloc, Sharing>;
+  using Node = typename List::Node;
+  if (n < 0 || n > list.Length())
+    throw std::out_of_range("Invalid split Index");
+
+  typename List::Chain prefix;
+  List reversed_suffix;
+  int remaining = n;
+  // The uniquely-owned part of list is consumed and its nodes reused.
+  while (list.OwnsHead()) {
+    auto node = list.TakeHead();
+    if (remaining > 0) {
+      node->size_ = remaining--;
+      prefix.Link(std::move(node));
+    } else {
+      node->size_ = reversed_suffix.Length() + 1;
+      node->next_ = std::move(reversed_suffix);
+      reversed_suffix.value_ = std::move(node);
+    }
+  }
+  CountNodesCopied(list.Length());
+  for (Node* cur = list.value_.get(); cur != nullptr;
+       cur = cur->next_.value_.get()) {
+    if (remaining > 0) {
+      prefix.Link(List::MakeNode(cur->value_, List(), remaining--));
+    } else {
+      reversed_suffix = List::MakeCons(std::move(reversed_suffix), cur->value_);
+    }
+  }
+  return std::make_pair(prefix.Release(List()), std::move(reversed_suffix));
 }
 
-template <typename T>
-LinkedList<T> Reverse(LinkedList<T> list) {
-  LinkedList<T> reversed_list = LinkedList<T>::Empty();
-  while (!list.IsEmpty()) {
-    reversed_list = reversed_list.Cons(list.Head());
-    list = list.Tail();
+// Nodes that list solely owns are relinked in reverse order rather than
+// copied, so reversing a uniquely-owned list allocates nothing.
+template <typename T, typename Alloc, typename Sharing>
+LinkedList<T, Alloc, Sharing> Reverse(LinkedList<T, Alloc, Sharing> list) {
+  using List = LinkedList<T, Alloc, Sharing>;
+  using Node = typename List::Node;
+  List reversed_list;
+  while (list.OwnsHead()) {
+    auto node = list.TakeHead();
+    node->size_ = reversed_list.Length() + 1;
+    node->next_ = std::move(reversed_list);
+    reversed_list.value_ = std::move(node);
   }
+  CountNodesCopied(list.Length());
+  for (Node* cur = list.value_.get(); cur != nullptr;
+       cur = cur->next_.value_.get())
+    reversed_list = List::MakeCons(std::move(reversed_list), cur->value_);
   return reversed_list;
 }
 
@@ -0,0 +1,154 @@
+#ifndef ALLOCATOR_POOL_ALLOCATOR_H
+#define ALLOCATOR_POOL_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+// Fixed-size block pool backing PoolAllocator. There is one pool per block
+// size and alignment, and each thread has its own instance of it, so the
+// common allocate/deallocate path takes no locks and never touches the
+// global heap.
+// Design notes:
+// - Blocks are carved out of chunks taken from ::operator new and kept on an
+//   intrusive free list. Chunks are never handed back, because a node may
+//   outlive the thread that allocated it and can be freed on any thread.
+// - When a thread exits, its free list is handed to a global orphan list.
+//   Other threads adopt that list before they carve a new chunk, so pools of
+//   short-lived threads do not leak.
+template <std::size_t BlockSize, std::size_t Alignment>
+class NodePool {
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  static constexpr std::size_t kAlignment =
+      std::max(Alignment, alignof(FreeBlock));
+  static constexpr std::size_t kBlockSize =
+      (std::max(BlockSize, sizeof(FreeBlock)) + kAlignment - 1) / kAlignment *
+      kAlignment;
+  static constexpr std::size_t kChunkBytes = 64 * 1024;
+  static constexpr std::size_t kBlocksPerChunk =
+      std::max<std::size_t>(kChunkBytes / kBlockSize, 16);
+
+  FreeBlock* free_ = nullptr;
+
+  // Blocks released by threads that have since exited.
+  static std::mutex& OrphanMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+  static FreeBlock*& Orphans() {
+    static FreeBlock* orphans = nullptr;
+    return orphans;
+  }
+  // Trivially destructible, so it stays readable while thread-local objects
+  // that still own nodes are being destroyed after the pool itself.
+  static bool& LocalDestroyed() {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static void Orphan(FreeBlock* first, FreeBlock* last) {
+    const std::lock_guard lock(OrphanMutex());
+    last->next_ = Orphans();
+    Orphans() = first;
+  }
+
+  void Refill() {
+    {
+      const std::lock_guard lock(OrphanMutex());
+      if (Orphans() != nullptr) {
+        free_ = Orphans();
+        Orphans() = nullptr;
+        return;
+      }
+    }
+    auto* chunk = static_cast<std::byte*>(::operator new(
+        kBlockSize * kBlocksPerChunk, std::align_val_t(kAlignment)));
+    for (std::size_t i = kBlocksPerChunk; i > 0; i--) {
+      auto* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * kBlockSize);
+      block->next_ = free_;
+      free_ = block;
+    }
+  }
+
+  NodePool() = default;
+
+ public:
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+  NodePool(NodePool&&) = delete;
+  NodePool& operator=(NodePool&&) = delete;
+
+  ~NodePool() {
+    LocalDestroyed() = true;
+    if (free_ == nullptr) return;
+    FreeBlock* last = free_;
+    while (last->next_ != nullptr) last = last->next_;
+    Orphan(free_, last);
+  }
+
+  static NodePool& Local() {
+    thread_local NodePool pool;
+    return pool;
+  }
+
+  static void* Allocate() {
+    NodePool& pool = Local();
+    if (pool.free_ == nullptr) pool.Refill();
+    FreeBlock* block = pool.free_;
+    pool.free_ = block->next_;
+    return block;
+  }
+
+  static void Deallocate(void* pointer) {
+    auto* block = static_cast<FreeBlock*>(pointer);
+    if (LocalDestroyed()) {
+      Orphan(block, block);
+      return;
+    }
+    NodePool& pool = Local();
+    block->next_ = pool.free_;
+    pool.free_ = block;
+  }
+};
+
+// Stateless allocator that serves single-object allocations from the calling
+// thread's NodePool and forwards array allocations to ::operator new.
+// std::allocate_shared rebinds it to its internal control block type, so the
+// pool it ends up using is sized exactly for a list node and its refcounts.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& /*other*/) noexcept {}  // NOLINT
+
+  [[nodiscard]] T* allocate(const std::size_t n) {
+    if (n == 1)
+      return static_cast<T*>(NodePool<sizeof(T), alignof(T)>::Allocate());
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+  }
+
+  void deallocate(T* pointer, const std::size_t n) noexcept {
+    if (n == 1) {
+      NodePool<sizeof(T), alignof(T)>::Deallocate(pointer);
+      return;
+    }
+    ::operator delete(pointer, std::align_val_t(alignof(T)));
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>& /*other*/) const noexcept {
+    return true;
+  }
+};
+
+#endif  // ALLOCATOR_POOL_ALLOCATOR_H
@@ -0,0 +1,90 @@
+#ifndef ATOMICREF_ATOMIC_REF_H
+#define ATOMICREF_ATOMIC_REF_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+// Mutable, thread-safe reference to an immutable value such as a
+// LinkedList<T> or Deque<T>, for publishing new versions from writers to
+// readers without a mutex.
+// Representation:
+// - The current version is boxed in a std::shared_ptr<const X> and held in a
+//   std::atomic<std::shared_ptr<const X>>. Readers take a reference to the
+//   box, so a version stays alive for as long as any reader still uses it,
+//   and then it is reclaimed by ordinary reference counting.
+// Design notes:
+// - Writers update functionally: Update(fn) computes fn(current) and
+//   publishes it with a compare-and-swap, retrying if another writer got in
+//   first. fn may therefore run more than once and should have no side
+//   effects.
+// - CompareExchange compares versions by identity (the box), not by value,
+//   so it is O(1) whatever X is.
+// - libstdc++ implements std::atomic<std::shared_ptr> with a spin bit in the
+//   control block pointer rather than a mutex. Loads and stores are short,
+//   bounded critical sections, and no operation ever blocks in the kernel.
+// - X must be safe to share between threads, which rules out structures
+//   using LocalSharing.
+template <typename X>
+class AtomicRef {
+ public:
+  // A published version. Comparing two of them compares identity.
+  using Version = std::shared_ptr<const X>;
+
+ private:
+  std::atomic<Version> current_;
+
+  static Version Box(X value) {
+    return std::make_shared<const X>(std::move(value));
+  }
+
+ public:
+  // Starts out holding X::Empty().
+  AtomicRef() : current_(Box(X::Empty())) {}
+  explicit AtomicRef(X initial) : current_(Box(std::move(initial))) {}
+
+  AtomicRef(const AtomicRef&) = delete;
+  AtomicRef& operator=(const AtomicRef&) = delete;
+
+  // Snapshot of the current value.
+  [[nodiscard]] X Load() const { return *LoadVersion(); }
+
+  // The current version itself, to pass to CompareExchange later.
+  [[nodiscard]] Version LoadVersion() const {
+    return current_.load(std::memory_order_acquire);
+  }
+
+  void Store(X value) {
+    current_.store(Box(std::move(value)), std::memory_order_release);
+  }
+
+  // Publish value and return the version it replaced.
+  Version Exchange(X value) {
+    return current_.exchange(Box(std::move(value)), std::memory_order_acq_rel);
+  }
+
+  // Publish desired if expected is still the current version. Otherwise
+  // leave the reference alone, set expected to the current version and
+  // return false.
+  bool CompareExchange(Version& expected, X desired) {
+    return current_.compare_exchange_strong(expected, Box(std::move(desired)),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire);
+  }
+
+  // Replace the value with fn(value), retrying until no other writer
+  // interferes. Returns the value that was published.
+  template <typename Fn>
+  X Update(Fn fn) {
+    Version expected = LoadVersion();
+    for (;;) {
+      Version desired = Box(fn(*expected));
+      if (current_.compare_exchange_weak(expected, desired,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+        return *desired;
+    }
+  }
+};
+
+#endif  // ATOMICREF_ATOMIC_REF_H
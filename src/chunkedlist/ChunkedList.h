@@ -0,0 +1,301 @@
+#ifndef CHUNKEDLIST_CHUNKED_LIST_H
+#define CHUNKEDLIST_CHUNKED_LIST_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "linkedlist/LinkedList.h"
+#include "sharing/Sharing.h"
+
+// Bytes of elements per ChunkedList node by default.
+inline constexpr std::size_t kChunkBytes = 64;
+
+// Default elements per node: enough to fill a cache line, and at least one.
+template <typename T>
+inline constexpr int kDefaultChunkSize =
+    static_cast<int>(std::max<std::size_t>(1, kChunkBytes / sizeof(T)));
+
+// Immutable singly-linked list that stores up to N elements per node
+// (an unrolled list), with the same functional API as LinkedList.
+// Representation:
+// - A node holds an array of N slots filled from the back: the first element
+//   consed onto a fresh node goes into slot N - 1, the next into N - 2, and
+//   so on. Slots [first_, N) are constructed.
+// - A list is a node plus an offset. It holds the node's slots from offset_
+//   to N - 1, followed by the node's next_ list.
+// Design notes:
+// - Cons onto a list whose offset_ equals its node's first_ claims the free
+//   slot in front of it with a compare-and-swap and shares the node. Any
+//   other version consing onto the same node finds the slot taken and starts
+//   a fresh node, so published slots are never overwritten.
+// - Walking the list touches one node per N elements, so scans of small T
+//   stay within a few cache lines per chunk instead of chasing a pointer per
+//   element.
+// - Length() is O(1): each node caches the length of its next_ list.
+// - Destruction is iterative, as in LinkedList.
+// - Methods that require a non-empty list throw std::runtime_error, as
+//   LinkedList does.
+// - Alloc and Sharing have the same meaning as for LinkedList.
+template <typename T, int N = kDefaultChunkSize<T>,
+          typename Alloc = std::allocator<T>,
+          typename Sharing = AtomicSharing>
+class ChunkedList {
+  static_assert(N > 0, "ChunkedList needs at least one element per node");
+
+  struct Node {
+    std::atomic<int> first_;
+    int rest_size_;
+    ChunkedList next_;
+    alignas(T) std::byte storage_[N * sizeof(T)];
+
+    // A fresh node holding one element, constructed in place in its last
+    // slot.
+    template <typename... Args>
+    explicit Node(ChunkedList next, Args&&... args)
+        : first_(N), rest_size_(next.Length()), next_(std::move(next)) {
+      std::construct_at(Slot(N - 1), std::forward<Args>(args)...);
+      first_.store(N - 1, std::memory_order_relaxed);
+    }
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+    Node(Node&&) = delete;
+    Node& operator=(Node&&) = delete;
+    ~Node() {
+      std::destroy(Slot(first_.load(std::memory_order_acquire)), Slot(N));
+    }
+
+    T* Slot(const int index) {
+      return std::launder(reinterpret_cast<T*>(storage_)) + index;
+    }
+    const T* Slot(const int index) const {
+      return std::launder(reinterpret_cast<const T*>(storage_)) + index;
+    }
+  };
+  using NodePtr = typename Sharing::template Ptr<Node, Alloc>;
+
+  // Null for the empty list.
+  NodePtr node_;
+  int offset_;
+
+  ChunkedList(NodePtr node, const int offset)
+      : node_(std::move(node)), offset_(offset) {}
+
+  template <typename... Args>
+  [[nodiscard]] ChunkedList MakeCons(Args&&... args) const {
+    if (node_ != nullptr && offset_ > 0) {
+      int expected = offset_;
+      if (node_->first_.compare_exchange_strong(expected, offset_ - 1,
+                                                std::memory_order_acq_rel)) {
+        // Nobody else can claim the next slot until we publish this list,
+        // so giving the slot back on failure is safe.
+        try {
+          std::construct_at(node_->Slot(offset_ - 1),
+                            std::forward<Args>(args)...);
+        } catch (...) {
+          node_->first_.store(offset_, std::memory_order_release);
+          throw;
+        }
+        return ChunkedList(node_, offset_ - 1);
+      }
+    }
+    return ChunkedList(
+        Sharing::template Make<Node, Alloc>(*this, std::forward<Args>(args)...),
+        N - 1);
+  }
+
+ public:
+  ChunkedList() : node_(nullptr), offset_(0) {}
+
+  ChunkedList(const ChunkedList& other) = default;
+  ChunkedList(ChunkedList&& other) noexcept = default;
+  ChunkedList& operator=(const ChunkedList& other) = default;
+  ChunkedList& operator=(ChunkedList&& other) noexcept = default;
+
+  // Unlink uniquely-owned nodes in a loop, as ~LinkedList does.
+  ~ChunkedList() {
+    while (node_ != nullptr && node_.use_count() == 1) {
+      NodePtr next = std::move(node_->next_.node_);
+      node_ = std::move(next);
+    }
+  }
+
+  [[nodiscard]] static ChunkedList Empty() { return ChunkedList(); }
+
+  [[nodiscard]] static ChunkedList Single(const T& element) {
+    return Empty().Cons(element);
+  }
+
+  // Build from a LinkedList in O(n), packing the elements into full nodes.
+  template <typename ListAlloc, typename ListSharing>
+  [[nodiscard]] static ChunkedList FromList(
+      const LinkedList<T, ListAlloc, ListSharing>& list) {
+    std::vector<const T*> elements;
+    elements.reserve(list.Length());
+    for (const T& element : list) elements.push_back(&element);
+    ChunkedList result;
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it)
+      result = result.Cons(**it);
+    return result;
+  }
+
+  template <typename ListAlloc = std::allocator<T>,
+            typename ListSharing = AtomicSharing>
+  [[nodiscard]] LinkedList<T, ListAlloc, ListSharing> ToList() const {
+    typename LinkedList<T, ListAlloc, ListSharing>::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  [[nodiscard]] bool IsEmpty() const { return node_ == nullptr; }
+
+  [[nodiscard]] bool IsSingle() const { return Length() == 1; }
+
+  [[nodiscard]] int Length() const {
+    if (IsEmpty()) return 0;
+    return N - offset_ + node_->rest_size_;
+  }
+
+  // Prepend element (functional): returns new list with element as head.
+  [[nodiscard]] ChunkedList Cons(const T& element) const {
+    return MakeCons(element);
+  }
+  [[nodiscard]] ChunkedList Cons(T&& element) const {
+    return MakeCons(std::move(element));
+  }
+
+  template <typename... Args>
+  [[nodiscard]] ChunkedList EmplaceCons(Args&&... args) const {
+    return MakeCons(std::forward<Args>(args)...);
+  }
+
+  // Return head value. Throws std::runtime_error if list is empty.
+  [[nodiscard]] const T& Head() const {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call head on an empty list");
+    return *node_->Slot(offset_);
+  }
+
+  // Return tail. Throws std::runtime_error if list is empty. O(1): the tail
+  // shares this list's node.
+  [[nodiscard]] ChunkedList Tail() const {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call tail on an empty list");
+    if (offset_ + 1 < N) return ChunkedList(node_, offset_ + 1);
+    return node_->next_;
+  }
+
+  // Return last element. Throws std::runtime_error if list is empty.
+  [[nodiscard]] const T& Last() const {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call last on an empty list");
+    const Node* cur = node_.get();
+    while (!cur->next_.IsEmpty()) cur = cur->next_.node_.get();
+    return *cur->Slot(N - 1);
+  }
+
+  // Indexing: 0-based. Throws std::out_of_range if index invalid. Skips a
+  // whole node at a time.
+  [[nodiscard]] const T& Index(int index) const {
+    if (index < 0 || index >= Length())
+      throw std::out_of_range("Index out of range");
+    const Node* cur = node_.get();
+    int offset = offset_;
+    while (index >= N - offset) {
+      index -= N - offset;
+      offset = cur->next_.offset_;
+      cur = cur->next_.node_.get();
+    }
+    return *cur->Slot(offset + index);
+  }
+
+  // Call fn with the elements of each node, in order, as a
+  // std::span<const T>. Stops early once fn returns false. Used by the
+  // kernels in simd/Scan.h.
+  template <typename Fn>
+  void ForEachChunk(Fn fn) const {
+    const Node* cur = node_.get();
+    int offset = offset_;
+    while (cur != nullptr) {
+      if (!fn(std::span<const T>(cur->Slot(offset), N - offset))) return;
+      offset = cur->next_.offset_;
+      cur = cur->next_.node_.get();
+    }
+  }
+
+  // Calls fn(node, bytes) for each node, as LinkedList::ForEachNode does. A
+  // node counts in full, whichever of its slots this list uses.
+  template <typename Fn>
+  void ForEachNode(Fn fn) const {
+    constexpr std::size_t kBytes =
+        Sharing::template kBlockBytes<Node, Alloc>;
+    for (const Node* cur = node_.get(); cur != nullptr;
+         cur = cur->next_.node_.get())
+      if (!fn(static_cast<const void*>(cur), kBytes)) return;
+  }
+
+  // Read-only forward iterator. Like LinkedList::const_iterator it touches no
+  // reference counts; the list it came from must outlive it.
+  class const_iterator {
+    const Node* node_ = nullptr;
+    int offset_ = 0;
+
+    const_iterator(const Node* node, const int offset)
+        : node_(node), offset_(offset) {}
+    friend class ChunkedList;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return *node_->Slot(offset_); }
+    pointer operator->() const { return node_->Slot(offset_); }
+
+    const_iterator& operator++() {
+      if (++offset_ == N) {
+        offset_ = node_->next_.offset_;
+        node_ = node_->next_.node_.get();
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    bool operator==(const const_iterator& other) const = default;
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator(node_.get(), offset_);
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+};
+
+// Reverse a ChunkedList in O(n). The result is packed into full nodes.
+template <typename T, int N, typename Alloc, typename Sharing>
+ChunkedList<T, N, Alloc, Sharing> Reverse(
+    const ChunkedList<T, N, Alloc, Sharing>& list) {
+  ChunkedList<T, N, Alloc, Sharing> reversed;
+  for (const T& element : list) reversed = reversed.Cons(element);
+  return reversed;
+}
+
+#endif  // CHUNKEDLIST_CHUNKED_LIST_H
@@ -2,28 +2,83 @@
 #define DEQUE_DEQUE_H
 
 #include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "Utils.h"
+#include "hash/Hash.h"
+#include "instrumentation/Instrumentation.h"
 #include "linkedlist/LinkedList.h"
 
-template <typename T>
+// Both halves are LinkedLists allocating their nodes with Alloc and
+// reference counting them according to Sharing.
+template <typename T, typename Alloc = std::allocator<T>,
+          typename Sharing = AtomicSharing>
 class Deque {
-  LinkedList<T> front_;
-  LinkedList<T> back_;
+  template <typename, typename, typename>
+  friend class Deque;
+  template <typename>
+  friend class SnapshotWriter;
 
-  Deque RebalancedIfNecessary() const {
-    if (IsEmpty() || IsSingle() || (!front_.IsEmpty() && !back_.IsEmpty()))
-      return *this;
+ public:
+  using List = LinkedList<T, Alloc, Sharing>;
+
+ private:
+  List front_;
+  List back_;
+
+  // True if both deques hold exactly the same nodes.
+  [[nodiscard]] bool SharesAll(const Deque& other) const {
+    return front_.value_ == other.front_.value_ &&
+           back_.value_ == other.back_.value_;
+  }
+
+  // The first count elements of list, split for a balanced deque: the first
+  // count / 2 of them copied in order, and the rest of them copied in
+  // reverse. A single pass, like the rebalance it replaces.
+  static std::pair<List, List> SplitPrefix(const List& list, const int count) {
+    CountRebalance(count);
+    auto [prefix, rest] = SplitAt(count / 2, list);
+    CountNodesCopied(count - count / 2);
+    List reversed;
+    auto it = rest.begin();
+    for (int i = count / 2; i < count; i++, ++it)
+      reversed = List::MakeCons(std::move(reversed), *it);
+    return {std::move(prefix), std::move(reversed)};
+  }
+
+  [[nodiscard]] bool IsBalanced() const {
+    return IsEmpty() || IsSingle() || (!front_.IsEmpty() && !back_.IsEmpty());
+  }
+
+  Deque RebalancedIfNecessary() const& {
+    if (IsBalanced()) return *this;
+    return Deque(*this).RebalancedIfNecessary();
+  }
 
+  // Splitting a half this deque solely owns relinks its nodes instead of
+  // copying them (see SplitAndReverse).
+  Deque RebalancedIfNecessary() && {
+    if (IsBalanced()) return std::move(*this);
+
+    CountRebalance(Length());
     if (front_.IsEmpty()) {
-      const auto [new_back, new_reversed_front] =
-          SplitAt(back_.Length() / 2, back_);
-      return Deque(Reverse(new_reversed_front), new_back);
+      const int half = back_.Length() / 2;
+      auto [new_back, new_front] = SplitAndReverse(half, std::move(back_));
+      return Deque(std::move(new_front), std::move(new_back));
     }
-    const auto [new_front, new_reversed_back] =
-        SplitAt(front_.Length() / 2, front_);
-    return Deque(new_front, Reverse(new_reversed_back));
+    const int half = front_.Length() / 2;
+    auto [new_front, new_back] = SplitAndReverse(half, std::move(front_));
+    return Deque(std::move(new_front), std::move(new_back));
   }
 
  public:
@@ -46,78 +101,198 @@ class Deque {
     return *this;
   }
 
-  Deque(LinkedList<T> front,  // NOLINT(*-easily-swappable-parameters)
-        LinkedList<T> back)
-      : front_(front), back_(back) {}
+  Deque(List front, List back)  // NOLINT(*-easily-swappable-parameters)
+      : front_(std::move(front)), back_(std::move(back)) {}
 
-  static Deque FromList(const LinkedList<T>& list) {
-    const auto [listA, listB] = SplitAt(list.Length() / 2, list);
-    return Deque(listA, Reverse(listB));
+  // Nodes of list that are not shared elsewhere have their elements moved.
+  static Deque FromList(List list) {
+    const int half = list.Length() / 2;
+    auto [front, back] = SplitAndReverse(half, std::move(list));
+    return Deque(std::move(front), std::move(back));
   };
 
-  LinkedList<T> ToList() const { return front_.Append(Reverse(back_)); };
-
-  static Deque Empty() {
-    return Deque(LinkedList<T>::Empty(), LinkedList<T>::Empty());
+  List ToList() const& { return front_.Append(Reverse(back_)); };
+  // Reuses the nodes this deque solely owns.
+  List ToList() && {
+    return std::move(front_).Append(Reverse(std::move(back_)));
   };
 
+  static Deque Empty() { return Deque(List::Empty(), List::Empty()); };
+
   static Deque Single(const T& element) {
-    return Deque(LinkedList<T>::Single(element), LinkedList<T>::Empty());
+    return Deque(List::Single(element), List::Empty());
   };
+  static Deque Single(T&& element) {
+    return Deque(List::Single(std::move(element)), List::Empty());
+  };
+
+  Deque Cons(const T& element) const { return EmplaceCons(element); };
+  Deque Cons(T&& element) const { return EmplaceCons(std::move(element)); };
 
-  Deque Cons(const T& element) const {
-    if (back_.IsEmpty()) return Deque(LinkedList<T>::Single(element), front_);
-    return Deque(front_.Cons(element), back_);
+  // Prepend an element constructed in place from args.
+  template <typename... Args>
+  Deque EmplaceCons(Args&&... args) const {
+    if (back_.IsEmpty())
+      return Deque(List::EmplaceSingle(std::forward<Args>(args)...), front_);
+    return Deque(front_.EmplaceCons(std::forward<Args>(args)...), back_);
   };
 
-  Deque Snoc(const T& element) const {
-    if (front_.IsEmpty()) return Deque(back_, LinkedList<T>::Single(element));
-    return Deque(front_, back_.Cons(element));
+  Deque Snoc(const T& element) const { return EmplaceSnoc(element); };
+  Deque Snoc(T&& element) const { return EmplaceSnoc(std::move(element)); };
+
+  // Append an element constructed in place from args.
+  template <typename... Args>
+  Deque EmplaceSnoc(Args&&... args) const {
+    if (front_.IsEmpty())
+      return Deque(back_, List::EmplaceSingle(std::forward<Args>(args)...));
+    return Deque(front_, back_.EmplaceCons(std::forward<Args>(args)...));
   };
 
-  T Head() const {
+  const T& Head() const {
     if (IsEmpty())
       throw std::invalid_argument("Cannot call Head on an empty list");
     if (!front_.IsEmpty()) return front_.Head();
     return back_.Last();
   };
 
-  Deque Tail() const {
+  Deque Tail() const& {
     if (IsEmpty())
       throw std::invalid_argument("Cannot call Tail on an empty list");
     if (front_.IsEmpty() || back_.IsEmpty()) return Empty();
     return Deque(front_.Tail(), back_).RebalancedIfNecessary();
   };
 
-  Deque Init() const {
+  // Tail consuming this deque, e.g. std::move(queue).Tail() in a loop that
+  // drains it. No reference counts change for nodes the deque solely owns,
+  // and the rebalance this may trigger relinks them instead of copying.
+  Deque Tail() && {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Tail on an empty list");
+    if (front_.IsEmpty() || back_.IsEmpty()) return Empty();
+    return Deque(std::move(front_).Tail(), std::move(back_))
+        .RebalancedIfNecessary();
+  };
+
+  Deque Init() const& {
     if (IsEmpty())
       throw std::invalid_argument("Cannot call Init on an empty list");
     if (front_.IsEmpty() || back_.IsEmpty()) return Empty();
     return Deque(front_, back_.Tail()).RebalancedIfNecessary();
   };
 
-  T Last() const {
+  // Init consuming this deque; the mirror image of Tail() &&.
+  Deque Init() && {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Init on an empty list");
+    if (front_.IsEmpty() || back_.IsEmpty()) return Empty();
+    return Deque(std::move(front_), std::move(back_).Tail())
+        .RebalancedIfNecessary();
+  };
+
+  const T& Last() const {
     if (IsEmpty())
       throw std::invalid_argument("Cannot call Last on an empty list");
     if (!back_.IsEmpty()) return back_.Head();
     return front_.Last();
   };
 
+  // Prepend the elements of range, keeping their order, so that the first of
+  // them becomes Head(). Builds them into one chain in front of front_ and
+  // rebalances at most once, instead of once per Cons.
+  template <std::ranges::input_range R>
+  Deque ConsRange(R&& range) const {
+    typename List::Builder builder;
+    for (auto&& element : range)
+      builder.Snoc(std::forward<decltype(element)>(element));
+    return Deque(builder.BuildOnto(front_), back_).RebalancedIfNecessary();
+  }
+
+  // Append the elements of range, keeping their order, so that the last of
+  // them becomes Last(). back_ holds elements last first, so the batch is
+  // built reversed directly in front of it.
+  template <std::ranges::input_range R>
+  Deque SnocRange(R&& range) const {
+    typename List::Builder builder;
+    for (auto&& element : range)
+      builder.Cons(std::forward<decltype(element)>(element));
+    return Deque(front_, builder.BuildOnto(back_)).RebalancedIfNecessary();
+  }
+
+  // All but the first n elements. Skips within front_ without copying; if
+  // the drop reaches into back_, the survivors are rebuilt as a balanced
+  // deque in one pass. Throws std::out_of_range unless 0 <= n <= Length().
+  Deque DropFront(const int n) const {
+    const int length = Length();
+    if (n < 0 || n > length) throw std::out_of_range("Index out of range");
+    if (n == 0) return *this;
+    if (n == length) return Empty();
+    if (n < front_.Length())
+      return Deque(front_.Drop(n), back_).RebalancedIfNecessary();
+    auto [back, front] = SplitPrefix(back_, length - n);
+    return Deque(std::move(front), std::move(back));
+  }
+
+  // All but the last n elements; the mirror image of DropFront. Throws
+  // std::out_of_range unless 0 <= n <= Length().
+  Deque DropBack(const int n) const {
+    const int length = Length();
+    if (n < 0 || n > length) throw std::out_of_range("Index out of range");
+    if (n == 0) return *this;
+    if (n == length) return Empty();
+    if (n < back_.Length())
+      return Deque(front_, back_.Drop(n)).RebalancedIfNecessary();
+    auto [front, back] = SplitPrefix(front_, length - n);
+    return Deque(std::move(front), std::move(back));
+  }
+
+  // The first n elements. Throws std::out_of_range unless
+  // 0 <= n <= Length().
+  Deque TakeFront(const int n) const {
+    if (n < 0 || n > Length()) throw std::out_of_range("Index out of range");
+    return DropBack(Length() - n);
+  }
+
   [[nodiscard]] bool IsEmpty() const {
     return front_.IsEmpty() && back_.IsEmpty();
   };
 
-  [[nodiscard]] bool IsSingle() const {
-    return !IsEmpty() && (front_.IsEmpty() || back_.IsEmpty());
-  };
+  [[nodiscard]] bool IsSingle() const { return Length() == 1; };
 
+  // O(1): both halves cache their lengths.
   [[nodiscard]] int Length() const { return front_.Length() + back_.Length(); };
 
+  // O(min(Length(), listB.Length())): the larger operand keeps both of its
+  // halves and only the smaller one is copied into the adjacent half.
+  // - If this deque is smaller, its elements are consed, last first, onto
+  //   listB's front_.
+  // - Otherwise listB's elements are consed, first first, onto this deque's
+  //   back_, which holds the elements in reverse.
   Deque Append(const Deque& listB) const {
-    return FromList(this->ToList().Append(listB.ToList()));
+    if (IsEmpty()) return listB;
+    if (listB.IsEmpty()) return *this;
+    if (Length() <= listB.Length()) {
+      // back_ is stored last element first, so consing it in stored order
+      // puts it in front of listB's front_ in the right order.
+      List middle = listB.front_;
+      for (const T& element : back_) middle = middle.Cons(element);
+      return Deque(front_.Append(middle), listB.back_)
+          .RebalancedIfNecessary();
+    }
+    List middle = back_;
+    for (const T& element : listB.front_) middle = middle.Cons(element);
+    return Deque(front_, listB.back_.Append(middle)).RebalancedIfNecessary();
+  }
+
+  // Copy into a deque using a different sharing policy, keeping the same
+  // front/back layout.
+  template <typename OtherSharing>
+  Deque<T, Alloc, OtherSharing> WithSharing() const {
+    return Deque<T, Alloc, OtherSharing>(
+        front_.template WithSharing<OtherSharing>(),
+        back_.template WithSharing<OtherSharing>());
   }
 
-  T Index(int index) const {
+  const T& Index(int index) const {
     if (index < 0) throw std::out_of_range("Index out of range");
     const int front_length = front_.Length();
     if (index < front_length) return front_.Index(index);
@@ -126,6 +301,196 @@ class Deque {
       return back_.Index(back_length - 1 - index);
     throw std::out_of_range("Index out of range");
   };
+
+  // Element-wise equality, independent of how the elements are split
+  // between the halves. When both deques split at the same point the halves
+  // are compared as lists, so shared nodes end the comparison early.
+  [[nodiscard]] friend bool operator==(const Deque& lhs, const Deque& rhs)
+    requires std::equality_comparable<T>
+  {
+    if (lhs.Length() != rhs.Length()) return false;
+    if (lhs.front_.Length() == rhs.front_.Length())
+      return lhs.front_ == rhs.front_ && lhs.back_ == rhs.back_;
+    const auto a = lhs.Elements();
+    const auto b = rhs.Elements();
+    return std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  // Lexicographic comparison of the elements in order.
+  [[nodiscard]] friend auto operator<=>(const Deque& lhs, const Deque& rhs)
+    requires std::three_way_comparable<T>
+  {
+    using Ordering = std::compare_three_way_result_t<T>;
+    if (lhs.SharesAll(rhs)) return Ordering(std::strong_ordering::equal);
+    const auto a = lhs.Elements();
+    const auto b = rhs.Elements();
+    return Ordering(std::lexicographical_compare_three_way(
+        a.begin(), a.end(), b.begin(), b.end()));
+  }
+
+  // Same value as Hash() of ToList(). Splitting the polynomial at the end of
+  // front_ reuses its cached hashes, so this is O(|back_|) plus whatever part
+  // of front_ has not been hashed before.
+  [[nodiscard]] std::size_t Hash() const
+    requires Hashable<T>
+  {
+    // back_ holds the last element first, so element j of it gets power j.
+    std::uint64_t back_polynomial = 0;
+    std::uint64_t power = 1;
+    for (const T& element : back_) {
+      back_polynomial += HashElement(element) * power;
+      power *= kHashMultiplier;
+    }
+    return FinalizeHash(front_.PolynomialHash() * power + back_polynomial,
+                        Length());
+  }
+
+  // The nodes of front_ and then those of back_; see
+  // LinkedList::ForEachNode.
+  template <typename Fn>
+  void ForEachNode(Fn fn) const {
+    front_.ForEachNode(fn);
+    back_.ForEachNode(fn);
+  }
+
+  // Forward range over the elements in order: front_ from head to end, then
+  // back_ in reverse. back_ is singly linked the wrong way round, so the range
+  // records pointers to its elements once, in a vector; no list is built and
+  // iterating touches no reference counts. The range keeps the nodes alive,
+  // and its iterators must not outlive it.
+  class ElementRange {
+    List front_;
+    List back_;
+    std::vector<const T*> back_elements_;
+
+   public:
+    class const_iterator {
+      typename List::const_iterator front_;
+      const T* const* back_ = nullptr;
+
+      const_iterator(typename List::const_iterator front,
+                     const T* const* back)
+          : front_(front), back_(back) {}
+      friend class ElementRange;
+
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using iterator_concept = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T*;
+      using reference = const T&;
+
+      const_iterator() = default;
+
+      reference operator*() const {
+        if (front_ != typename List::const_iterator()) return *front_;
+        return **back_;
+      }
+      pointer operator->() const { return &**this; }
+
+      const_iterator& operator++() {
+        if (front_ != typename List::const_iterator()) {
+          ++front_;
+        } else {
+          ++back_;
+        }
+        return *this;
+      }
+      const_iterator operator++(int) {
+        const_iterator before = *this;
+        ++*this;
+        return before;
+      }
+
+      bool operator==(const const_iterator& other) const = default;
+    };
+    using iterator = const_iterator;
+
+    ElementRange(List front, List back)
+        : front_(std::move(front)), back_(std::move(back)) {
+      back_elements_.resize(back_.Length());
+      auto slot = back_elements_.rbegin();
+      for (const T& element : back_) *slot++ = &element;
+    }
+
+    [[nodiscard]] const_iterator begin() const {
+      return const_iterator(front_.begin(), back_elements_.data());
+    }
+    [[nodiscard]] const_iterator end() const {
+      return const_iterator(front_.end(),
+                            back_elements_.data() + back_elements_.size());
+    }
+    [[nodiscard]] std::size_t size() const {
+      return static_cast<std::size_t>(front_.Length()) + back_elements_.size();
+    }
+  };
+
+  // O(|back_|) to set up; iteration itself is O(1) per element.
+  [[nodiscard]] ElementRange Elements() const {
+    return ElementRange(front_, back_);
+  }
+
+  // Builder for bulk construction. Both ends push onto the head of one of
+  // the two lists, which takes O(1) and copies nothing. The first element
+  // pushed goes on the side opposite to the pushes that follow, so Build()
+  // returns a deque that already has both sides non-empty and needs no
+  // rebalancing.
+  class Builder {
+    List front_;
+    List back_;
+
+   public:
+    Builder() = default;
+    // Continue building after the elements of initial, sharing its nodes.
+    explicit Builder(const Deque& initial)
+        : front_(initial.front_), back_(initial.back_) {}
+
+    [[nodiscard]] int Length() const {
+      return front_.Length() + back_.Length();
+    }
+
+    [[nodiscard]] bool IsEmpty() const { return Length() == 0; }
+
+    Builder& Snoc(const T& element) {
+      if (front_.IsEmpty()) {
+        // Single elements read the same in either direction.
+        front_ = back_;
+        back_ = List::Single(element);
+        if (front_.IsEmpty()) std::swap(front_, back_);
+        return *this;
+      }
+      back_ = back_.Cons(element);
+      return *this;
+    }
+
+    Builder& Cons(const T& element) {
+      if (back_.IsEmpty()) {
+        back_ = front_;
+        front_ = List::Single(element);
+        if (back_.IsEmpty()) std::swap(front_, back_);
+        return *this;
+      }
+      front_ = front_.Cons(element);
+      return *this;
+    }
+
+    // The deque built so far, in O(1), leaving the builder as it is: later
+    // pushes go onto new nodes in front of the ones the snapshot shares.
+    [[nodiscard]] Deque Snapshot() const { return Deque(front_, back_); }
+
+    // Freeze into a persistent deque and reset the builder.
+    [[nodiscard]] Deque Build() {
+      return Deque(std::exchange(front_, List()), std::exchange(back_, List()));
+    }
+  };
+};
+
+template <Hashable T, typename Alloc, typename Sharing>
+struct std::hash<Deque<T, Alloc, Sharing>> {
+  std::size_t operator()(const Deque<T, Alloc, Sharing>& deque) const {
+    return deque.Hash();
+  }
 };
 
 #endif  // DEQUE_DEQUE_H
@@ -0,0 +1,226 @@
+#ifndef DEQUE_REAL_TIME_DEQUE_H
+#define DEQUE_REAL_TIME_DEQUE_H
+
+#include <climits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "lazylist/LazyList.h"
+#include "linkedlist/LinkedList.h"
+
+// Persistent double-ended queue with worst-case O(1) Cons, Snoc, Head, Last,
+// Tail and Init (Okasaki, "Purely Functional Data Structures", section 8.4.3).
+// Representation:
+// - Two lazy streams, front_ and back_, hold the elements in order and in
+//   reverse order respectively, together with their lengths.
+// - Neither stream may grow longer than kBalance times the other plus one.
+//   When an operation would break that, the deque is rotated: half of the
+//   longer stream is moved onto the end of the shorter one. The rotation is
+//   only described up front; its work is done lazily, a constant amount at a
+//   time.
+// - front_schedule_ and back_schedule_ point at the first unevaluated cell of
+//   each stream. Every operation forces one or two cells from each schedule,
+//   so a rotation has been fully paid for before the next one can start.
+// Design notes:
+// - The streams are LazyLists, whose suspensions are memoised and evaluated
+//   at most once, even when several threads force the same cell, so old
+//   versions never repeat a rotation.
+//   This is what makes the bounds worst-case rather than amortised under
+//   persistent use.
+// - Methods that require a non-empty deque throw std::invalid_argument, as
+//   Deque does.
+template <typename T>
+class RealTimeDeque {
+  // c in Okasaki's presentation; 2 and 3 both keep the schedules ahead.
+  static constexpr int kBalance = 3;
+
+  // Memoised lazy streams; see LazyList for the sharing and threading
+  // guarantees the schedules rely on.
+  using Stream = LazyList<T>;
+
+  int front_length_;
+  Stream front_;
+  Stream front_schedule_;
+  int back_length_;
+  Stream back_;
+  Stream back_schedule_;
+
+  // NOLINTNEXTLINE(*-easily-swappable-parameters)
+  RealTimeDeque(const int front_length, Stream front, Stream front_schedule,
+                const int back_length, Stream back, Stream back_schedule)
+      : front_length_(front_length),
+        front_(std::move(front)),
+        front_schedule_(std::move(front_schedule)),
+        back_length_(back_length),
+        back_(std::move(back)),
+        back_schedule_(std::move(back_schedule)) {}
+
+  // Force the first cell of a schedule and advance past it.
+  static Stream Exec1(const Stream& schedule) {
+    const auto& value = schedule.Force();
+    return value.has_value() ? value->second : schedule;
+  }
+
+  static Stream Exec2(const Stream& schedule) {
+    return Exec1(Exec1(schedule));
+  }
+
+  // Strictly prepend the first n elements of stream onto acc in reverse
+  // order, i.e. reverse (take n stream) ++ acc.
+  static Stream ReverseOnto(int n, Stream stream, Stream acc) {
+    while (n > 0) {
+      const auto& value = stream.Force();
+      if (!value.has_value()) break;
+      acc = acc.Cons(value->first);
+      stream = Stream(value->second);
+      n--;
+    }
+    return acc;
+  }
+
+  // f ++ reverse r ++ acc, producing kBalance elements of r per element of f.
+  static Stream RotateRev(const Stream& f, const Stream& r, const Stream& acc) {
+    return Stream::Lazy([f, r, acc]() -> typename Stream::Value {
+      const auto& value = f.Force();
+      if (!value.has_value()) return ReverseOnto(INT_MAX, r, acc).Force();
+      return typename Stream::Value(
+          std::in_place, value->first,
+          RotateRev(value->second, r.Drop(kBalance),
+                    ReverseOnto(kBalance, r, acc)));
+    });
+  }
+
+  // f ++ reverse (drop j r), dropping kBalance elements of r per element of
+  // f until fewer than kBalance remain to be dropped.
+  static Stream RotateDrop(const Stream& f, const int j, const Stream& r) {
+    if (j < kBalance) return RotateRev(f, r.Drop(j), Stream());
+    return Stream::Lazy([f, j, r]() -> typename Stream::Value {
+      const auto& value = f.Force();
+      return typename Stream::Value(
+          std::in_place, value->first,
+          RotateDrop(value->second, j - kBalance, r.Drop(kBalance)));
+    });
+  }
+
+  // Restore the balance invariant, starting a rotation when one side has
+  // grown too long.
+  static RealTimeDeque Check(const int front_length, const Stream& front,
+                             const Stream& front_schedule,
+                             const int back_length, const Stream& back,
+                             const Stream& back_schedule) {
+    if (front_length > kBalance * back_length + 1) {
+      const int new_front_length = (front_length + back_length) / 2;
+      const int new_back_length = front_length + back_length - new_front_length;
+      const Stream new_front = front.Take(new_front_length);
+      const Stream new_back = RotateDrop(back, new_front_length, front);
+      return RealTimeDeque(new_front_length, new_front, new_front,
+                           new_back_length, new_back, new_back);
+    }
+    if (back_length > kBalance * front_length + 1) {
+      const int new_back_length = (front_length + back_length) / 2;
+      const int new_front_length = front_length + back_length - new_back_length;
+      const Stream new_back = back.Take(new_back_length);
+      const Stream new_front = RotateDrop(front, new_back_length, back);
+      return RealTimeDeque(new_front_length, new_front, new_front,
+                           new_back_length, new_back, new_back);
+    }
+    return RealTimeDeque(front_length, front, front_schedule, back_length,
+                         back, back_schedule);
+  }
+
+ public:
+  RealTimeDeque() : front_length_(0), back_length_(0) {}
+
+  static RealTimeDeque Empty() { return RealTimeDeque(); }
+
+  static RealTimeDeque Single(const T& element) {
+    return Empty().Cons(element);
+  }
+
+  // Build from a list in O(n) by repeated Snoc.
+  static RealTimeDeque FromList(const LinkedList<T>& list) {
+    RealTimeDeque deque;
+    for (LinkedList<T> cur = list; !cur.IsEmpty(); cur = cur.Tail())
+      deque = deque.Snoc(cur.Head());
+    return deque;
+  }
+
+  LinkedList<T> ToList() const {
+    // Collect back_ (stored reversed) first, then cons front_ onto it in
+    // reverse, so every element is consed exactly once.
+    LinkedList<T> list = LinkedList<T>::Empty();
+    for (Stream cur = back_;;) {
+      const auto& value = cur.Force();
+      if (!value.has_value()) break;
+      list = list.Cons(value->first);
+      cur = Stream(value->second);
+    }
+    LinkedList<T> reversed_front = LinkedList<T>::Empty();
+    for (Stream cur = front_;;) {
+      const auto& value = cur.Force();
+      if (!value.has_value()) break;
+      reversed_front = reversed_front.Cons(value->first);
+      cur = Stream(value->second);
+    }
+    while (!reversed_front.IsEmpty()) {
+      list = list.Cons(reversed_front.Head());
+      reversed_front = reversed_front.Tail();
+    }
+    return list;
+  }
+
+  RealTimeDeque Cons(const T& element) const {
+    return Check(front_length_ + 1, front_.Cons(element),
+                 Exec1(front_schedule_), back_length_, back_,
+                 Exec1(back_schedule_));
+  }
+
+  RealTimeDeque Snoc(const T& element) const {
+    return Check(front_length_, front_, Exec1(front_schedule_),
+                 back_length_ + 1, back_.Cons(element),
+                 Exec1(back_schedule_));
+  }
+
+  const T& Head() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Head on an empty list");
+    // The balance invariant means front_ can only be empty when back_ holds
+    // a single element.
+    if (front_length_ == 0) return back_.Force()->first;
+    return front_.Force()->first;
+  }
+
+  const T& Last() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Last on an empty list");
+    if (back_length_ == 0) return front_.Force()->first;
+    return back_.Force()->first;
+  }
+
+  RealTimeDeque Tail() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Tail on an empty list");
+    if (front_length_ == 0) return Empty();
+    return Check(front_length_ - 1, front_.Force()->second,
+                 Exec2(front_schedule_), back_length_, back_,
+                 Exec2(back_schedule_));
+  }
+
+  RealTimeDeque Init() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Init on an empty list");
+    if (back_length_ == 0) return Empty();
+    return Check(front_length_, front_, Exec2(front_schedule_),
+                 back_length_ - 1, back_.Force()->second,
+                 Exec2(back_schedule_));
+  }
+
+  [[nodiscard]] bool IsEmpty() const { return Length() == 0; }
+
+  [[nodiscard]] bool IsSingle() const { return Length() == 1; }
+
+  [[nodiscard]] int Length() const { return front_length_ + back_length_; }
+};
+
+#endif  // DEQUE_REAL_TIME_DEQUE_H
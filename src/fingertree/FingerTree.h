@@ -0,0 +1,652 @@
+#ifndef FINGERTREE_FINGER_TREE_H
+#define FINGERTREE_FINGER_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+// A measure maps each element to a value of a monoid, and a finger tree
+// caches the combined value of every subtree. A measure provides:
+// - Value: the monoid's type.
+// - Identity(): the neutral value.
+// - Combine(a, b): the associative operation, in sequence order.
+// - Of(element): the value of one element.
+// Measures that count elements also provide Size(value), which enables the
+// positional operations (Length, Index, SplitAt).
+
+// Counts elements. This is the default measure.
+struct SizeMeasure {
+  using Value = int;
+
+  static Value Identity() { return 0; }
+  static Value Combine(const Value a, const Value b) { return a + b; }
+  template <typename T>
+  static Value Of(const T& /*element*/) {
+    return 1;
+  }
+  static int Size(const Value value) { return value; }
+};
+
+template <typename M>
+concept SizedMeasure = requires(const typename M::Value& value) {
+  { M::Size(value) } -> std::convertible_to<int>;
+};
+
+// Persistent sequence based on 2-3 finger trees (Hinze & Paterson, "Finger
+// trees: a simple general-purpose data structure").
+// Representation:
+// - Elements are items. A node is an item too, with two or three child
+//   items, so every nested level of the tree holds the same item type.
+//   Nested levels would otherwise need ever deeper template instantiations.
+// - Every item and every level caches its measure.
+// - A level is empty (null), single (one item) or deep: a prefix and a
+//   suffix digit of one to four items each, plus a middle level whose items
+//   are nodes.
+// Complexity:
+// - Cons, Snoc, Tail and Init are amortised O(1), and Head and Last are
+//   O(1).
+// - Append is O(log(min(n, m))).
+// - Split, SplitAt, Find and Index are O(log n).
+// Design notes:
+// - The middle levels are built strictly. The amortised bounds therefore
+//   hold for single-threaded (ephemeral) use, and every operation is still
+//   O(log n) in the worst case when old versions are reused.
+// - Split(pred) needs a predicate that is monotone over prefix measures:
+//   false for short prefixes, true from some point on.
+// - Methods that require a non-empty tree throw std::invalid_argument, as
+//   Deque does.
+template <typename T, typename Measure = SizeMeasure>
+class FingerTree {
+ public:
+  using Value = typename Measure::Value;
+
+ private:
+  struct Item {
+    Value measure_;
+    // 0 for elements, otherwise the number of children.
+    int arity_;
+
+    Item(Value measure, const int arity)
+        : measure_(std::move(measure)), arity_(arity) {}
+  };
+  using ItemPtr = std::shared_ptr<const Item>;
+
+  struct Element : Item {
+    T value_;
+
+    explicit Element(T value)
+        : Item(Measure::Of(value), 0), value_(std::move(value)) {}
+  };
+
+  struct Node : Item {
+    std::array<ItemPtr, 3> children_;
+
+    Node(ItemPtr a, ItemPtr b)
+        : Item(Measure::Combine(a->measure_, b->measure_), 2),
+          children_{std::move(a), std::move(b), nullptr} {}
+    Node(ItemPtr a, ItemPtr b, ItemPtr c)
+        : Item(Measure::Combine(Measure::Combine(a->measure_, b->measure_),
+                                c->measure_),
+               3),
+          children_{std::move(a), std::move(b), std::move(c)} {}
+  };
+
+  static const Element* AsElement(const Item* item) {
+    return static_cast<const Element*>(item);
+  }
+  static const Node* AsNode(const Item* item) {
+    return static_cast<const Node*>(item);
+  }
+
+  // One to four items at either end of a level. Empty digits only occur
+  // transiently while splitting.
+  struct Digit {
+    int count_ = 0;
+    std::array<ItemPtr, 4> items_;
+
+    Digit() = default;
+    Digit(std::initializer_list<ItemPtr> items)
+        : count_(static_cast<int>(items.size())) {
+      std::copy(items.begin(), items.end(), items_.begin());
+    }
+
+    // The children of a node.
+    static Digit OfNode(const Item* item) {
+      const Node* node = AsNode(item);
+      Digit digit;
+      for (int i = 0; i < node->arity_; i++)
+        digit.items_[i] = node->children_[i];
+      digit.count_ = node->arity_;
+      return digit;
+    }
+
+    const ItemPtr& operator[](const int index) const { return items_[index]; }
+    [[nodiscard]] const ItemPtr& Back() const { return items_[count_ - 1]; }
+
+    [[nodiscard]] Value Measured() const {
+      Value value = Measure::Identity();
+      for (int i = 0; i < count_; i++)
+        value = Measure::Combine(value, items_[i]->measure_);
+      return value;
+    }
+
+    [[nodiscard]] Digit PushedFront(ItemPtr item) const {
+      Digit digit;
+      digit.items_[0] = std::move(item);
+      for (int i = 0; i < count_; i++) digit.items_[i + 1] = items_[i];
+      digit.count_ = count_ + 1;
+      return digit;
+    }
+    [[nodiscard]] Digit PushedBack(ItemPtr item) const {
+      Digit digit = *this;
+      digit.items_[digit.count_++] = std::move(item);
+      return digit;
+    }
+    [[nodiscard]] Digit DroppedFront() const {
+      Digit digit;
+      for (int i = 1; i < count_; i++) digit.items_[i - 1] = items_[i];
+      digit.count_ = count_ - 1;
+      return digit;
+    }
+    [[nodiscard]] Digit DroppedBack() const {
+      Digit digit = *this;
+      digit.items_[--digit.count_] = nullptr;
+      return digit;
+    }
+  };
+
+  struct Level;
+  // Null for the empty tree.
+  using LevelPtr = std::shared_ptr<const Level>;
+
+  struct Level {
+    Value measure_;
+    Digit prefix_;
+    LevelPtr middle_;
+    // Empty for a single level, whose one item is prefix_[0].
+    Digit suffix_;
+
+    Level(Digit prefix, LevelPtr middle, Digit suffix)
+        : measure_(Measure::Combine(
+              Measure::Combine(prefix.Measured(), MeasureOf(middle)),
+              suffix.Measured())),
+          prefix_(std::move(prefix)),
+          middle_(std::move(middle)),
+          suffix_(std::move(suffix)) {}
+
+    [[nodiscard]] bool IsSingle() const { return suffix_.count_ == 0; }
+  };
+
+  LevelPtr root_;
+
+  explicit FingerTree(LevelPtr root) : root_(std::move(root)) {}
+
+  static Value MeasureOf(const LevelPtr& level) {
+    return level == nullptr ? Measure::Identity() : level->measure_;
+  }
+
+  static LevelPtr MakeSingle(ItemPtr item) {
+    return std::make_shared<const Level>(Digit{std::move(item)}, nullptr,
+                                         Digit());
+  }
+
+  static LevelPtr Deep(Digit prefix, LevelPtr middle, Digit suffix) {
+    return std::make_shared<const Level>(std::move(prefix), std::move(middle),
+                                         std::move(suffix));
+  }
+
+  static ItemPtr Node2(ItemPtr a, ItemPtr b) {
+    return std::make_shared<const Node>(std::move(a), std::move(b));
+  }
+  static ItemPtr Node3(ItemPtr a, ItemPtr b, ItemPtr c) {
+    return std::make_shared<const Node>(std::move(a), std::move(b),
+                                        std::move(c));
+  }
+
+  static LevelPtr PushFront(ItemPtr item, const LevelPtr& level) {
+    if (level == nullptr) return MakeSingle(std::move(item));
+    if (level->IsSingle())
+      return Deep(Digit{std::move(item)}, nullptr, level->prefix_);
+    const Digit& prefix = level->prefix_;
+    if (prefix.count_ == 4)
+      return Deep(Digit{std::move(item), prefix[0]},
+                  PushFront(Node3(prefix[1], prefix[2], prefix[3]),
+                            level->middle_),
+                  level->suffix_);
+    return Deep(prefix.PushedFront(std::move(item)), level->middle_,
+                level->suffix_);
+  }
+
+  static LevelPtr PushBack(const LevelPtr& level, ItemPtr item) {
+    if (level == nullptr) return MakeSingle(std::move(item));
+    if (level->IsSingle())
+      return Deep(level->prefix_, nullptr, Digit{std::move(item)});
+    const Digit& suffix = level->suffix_;
+    if (suffix.count_ == 4)
+      return Deep(level->prefix_,
+                  PushBack(level->middle_,
+                           Node3(suffix[0], suffix[1], suffix[2])),
+                  Digit{suffix[3], std::move(item)});
+    return Deep(level->prefix_, level->middle_,
+                suffix.PushedBack(std::move(item)));
+  }
+
+  static const ItemPtr& Front(const LevelPtr& level) {
+    return level->prefix_[0];
+  }
+  static const ItemPtr& Back(const LevelPtr& level) {
+    return level->IsSingle() ? level->prefix_[0] : level->suffix_.Back();
+  }
+
+  static LevelPtr FromDigit(const Digit& digit) {
+    LevelPtr level;
+    for (int i = 0; i < digit.count_; i++) level = PushBack(level, digit[i]);
+    return level;
+  }
+
+  static LevelPtr PopFront(const LevelPtr& level) {
+    if (level->IsSingle()) return nullptr;
+    if (level->prefix_.count_ > 1)
+      return Deep(level->prefix_.DroppedFront(), level->middle_,
+                  level->suffix_);
+    return DeepLeft(Digit(), level->middle_, level->suffix_);
+  }
+
+  static LevelPtr PopBack(const LevelPtr& level) {
+    if (level->IsSingle()) return nullptr;
+    if (level->suffix_.count_ > 1)
+      return Deep(level->prefix_, level->middle_,
+                  level->suffix_.DroppedBack());
+    return DeepRight(level->prefix_, level->middle_, Digit());
+  }
+
+  // A deep level whose prefix may be empty, borrowing a node from the
+  // middle level to refill it.
+  static LevelPtr DeepLeft(Digit prefix, const LevelPtr& middle,
+                           Digit suffix) {
+    if (prefix.count_ > 0)
+      return Deep(std::move(prefix), middle, std::move(suffix));
+    if (middle == nullptr) return FromDigit(suffix);
+    return Deep(Digit::OfNode(Front(middle).get()), PopFront(middle),
+                std::move(suffix));
+  }
+
+  static LevelPtr DeepRight(Digit prefix, const LevelPtr& middle,
+                            Digit suffix) {
+    if (suffix.count_ > 0)
+      return Deep(std::move(prefix), middle, std::move(suffix));
+    if (middle == nullptr) return FromDigit(prefix);
+    return Deep(std::move(prefix), PopBack(middle),
+                Digit::OfNode(Back(middle).get()));
+  }
+
+  // Group 2 to 12 items into nodes of two or three.
+  static std::vector<ItemPtr> Nodes(const std::vector<ItemPtr>& items) {
+    std::vector<ItemPtr> nodes;
+    std::size_t i = 0;
+    while (i < items.size()) {
+      const std::size_t remaining = items.size() - i;
+      if (remaining == 2 || remaining == 4) {
+        nodes.push_back(Node2(items[i], items[i + 1]));
+        i += 2;
+      } else {
+        nodes.push_back(Node3(items[i], items[i + 1], items[i + 2]));
+        i += 3;
+      }
+    }
+    return nodes;
+  }
+
+  // left ++ middle ++ right, where middle holds items of the same depth as
+  // the two levels.
+  static LevelPtr Concat(const LevelPtr& left,
+                         const std::vector<ItemPtr>& middle,
+                         const LevelPtr& right) {
+    if (left == nullptr) {
+      LevelPtr level = right;
+      for (auto it = middle.rbegin(); it != middle.rend(); ++it)
+        level = PushFront(*it, level);
+      return level;
+    }
+    if (right == nullptr) {
+      LevelPtr level = left;
+      for (const ItemPtr& item : middle) level = PushBack(level, item);
+      return level;
+    }
+    if (left->IsSingle())
+      return PushFront(left->prefix_[0], Concat(nullptr, middle, right));
+    if (right->IsSingle())
+      return PushBack(Concat(left, middle, nullptr), right->prefix_[0]);
+    std::vector<ItemPtr> items;
+    for (int i = 0; i < left->suffix_.count_; i++)
+      items.push_back(left->suffix_[i]);
+    items.insert(items.end(), middle.begin(), middle.end());
+    for (int i = 0; i < right->prefix_.count_; i++)
+      items.push_back(right->prefix_[i]);
+    return Deep(left->prefix_,
+                Concat(left->middle_, Nodes(items), right->middle_),
+                right->suffix_);
+  }
+
+  template <typename Digits>
+  struct Split3 {
+    Digits left_;
+    ItemPtr item_;
+    Digits right_;
+  };
+
+  // Split digit around the first item at which pred holds for the running
+  // measure, starting from acc. The last item is chosen if none qualifies.
+  template <typename Pred>
+  static Split3<Digit> SplitDigit(const Pred& pred, Value acc,
+                                  const Digit& digit) {
+    Split3<Digit> split;
+    int i = 0;
+    for (; i < digit.count_ - 1; i++) {
+      acc = Measure::Combine(acc, digit[i]->measure_);
+      if (pred(acc)) break;
+      split.left_.items_[split.left_.count_++] = digit[i];
+    }
+    split.item_ = digit[i];
+    for (int j = i + 1; j < digit.count_; j++)
+      split.right_.items_[split.right_.count_++] = digit[j];
+    return split;
+  }
+
+  // Split a non-empty level so that pred fails on acc combined with the
+  // measure of the left part and holds once the item is added.
+  template <typename Pred>
+  static Split3<LevelPtr> SplitLevel(const Pred& pred, const Value& acc,
+                                     const LevelPtr& level) {
+    if (level->IsSingle()) return {nullptr, level->prefix_[0], nullptr};
+    const Value after_prefix =
+        Measure::Combine(acc, level->prefix_.Measured());
+    if (pred(after_prefix)) {
+      auto split = SplitDigit(pred, acc, level->prefix_);
+      return {FromDigit(split.left_), split.item_,
+              DeepLeft(split.right_, level->middle_, level->suffix_)};
+    }
+    const Value after_middle =
+        Measure::Combine(after_prefix, MeasureOf(level->middle_));
+    if (pred(after_middle)) {
+      auto middle = SplitLevel(pred, after_prefix, level->middle_);
+      auto split = SplitDigit(
+          pred, Measure::Combine(after_prefix, MeasureOf(middle.left_)),
+          Digit::OfNode(middle.item_.get()));
+      return {DeepRight(level->prefix_, middle.left_, split.left_),
+              split.item_,
+              DeepLeft(split.right_, middle.right_, level->suffix_)};
+    }
+    auto split = SplitDigit(pred, after_middle, level->suffix_);
+    return {DeepRight(level->prefix_, level->middle_, split.left_),
+            split.item_, FromDigit(split.right_)};
+  }
+
+  // The first of items at which pred holds for the running measure, or the
+  // last one. Advances acc past the items before it.
+  template <typename Pred>
+  static const Item* FindIn(const Pred& pred, Value& acc,
+                            const ItemPtr* items, const int count) {
+    for (int i = 0; i < count - 1; i++) {
+      Value next = Measure::Combine(acc, items[i]->measure_);
+      if (pred(next)) return items[i].get();
+      acc = std::move(next);
+    }
+    return items[count - 1].get();
+  }
+
+  template <typename Pred>
+  static const Item* FindLevel(const Pred& pred, Value& acc,
+                               const LevelPtr& level) {
+    if (level->IsSingle()) return level->prefix_[0].get();
+    Value next = Measure::Combine(acc, level->prefix_.Measured());
+    if (pred(next))
+      return FindIn(pred, acc, level->prefix_.items_.data(),
+                    level->prefix_.count_);
+    acc = std::move(next);
+    if (level->middle_ != nullptr) {
+      next = Measure::Combine(acc, level->middle_->measure_);
+      if (pred(next)) {
+        const Item* node = FindLevel(pred, acc, level->middle_);
+        return FindIn(pred, acc, AsNode(node)->children_.data(),
+                      node->arity_);
+      }
+      acc = std::move(next);
+    }
+    return FindIn(pred, acc, level->suffix_.items_.data(),
+                  level->suffix_.count_);
+  }
+
+  template <typename It>
+  static FingerTree FromIterators(It first, const It last) {
+    LevelPtr level;
+    for (; first != last; ++first)
+      level = PushBack(level, std::make_shared<const Element>(*first));
+    return FingerTree(std::move(level));
+  }
+
+ public:
+  FingerTree() = default;
+
+  static FingerTree Empty() { return FingerTree(); }
+
+  static FingerTree Single(const T& element) {
+    return FingerTree(MakeSingle(std::make_shared<const Element>(element)));
+  }
+
+  template <typename Alloc, typename Sharing>
+  static FingerTree FromList(const LinkedList<T, Alloc, Sharing>& list) {
+    return FromIterators(list.begin(), list.end());
+  }
+
+  template <typename Alloc, typename Sharing>
+  static FingerTree FromDeque(const Deque<T, Alloc, Sharing>& deque) {
+    const auto elements = deque.Elements();
+    return FromIterators(elements.begin(), elements.end());
+  }
+
+  template <typename Alloc = std::allocator<T>,
+            typename Sharing = AtomicSharing>
+  LinkedList<T, Alloc, Sharing> ToList() const {
+    typename LinkedList<T, Alloc, Sharing>::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  template <typename Alloc = std::allocator<T>,
+            typename Sharing = AtomicSharing>
+  Deque<T, Alloc, Sharing> ToDeque() const {
+    typename Deque<T, Alloc, Sharing>::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  [[nodiscard]] bool IsEmpty() const { return root_ == nullptr; }
+
+  // Combined measure of all elements, in O(1).
+  [[nodiscard]] Value Measured() const { return MeasureOf(root_); }
+
+  [[nodiscard]] FingerTree Cons(const T& element) const {
+    return FingerTree(
+        PushFront(std::make_shared<const Element>(element), root_));
+  }
+
+  [[nodiscard]] FingerTree Snoc(const T& element) const {
+    return FingerTree(
+        PushBack(root_, std::make_shared<const Element>(element)));
+  }
+
+  [[nodiscard]] const T& Head() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Head on an empty tree");
+    return AsElement(Front(root_).get())->value_;
+  }
+
+  [[nodiscard]] const T& Last() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Last on an empty tree");
+    return AsElement(Back(root_).get())->value_;
+  }
+
+  [[nodiscard]] FingerTree Tail() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Tail on an empty tree");
+    return FingerTree(PopFront(root_));
+  }
+
+  [[nodiscard]] FingerTree Init() const {
+    if (IsEmpty())
+      throw std::invalid_argument("Cannot call Init on an empty tree");
+    return FingerTree(PopBack(root_));
+  }
+
+  // Concatenate: returns this ++ other.
+  [[nodiscard]] FingerTree Append(const FingerTree& other) const {
+    return FingerTree(Concat(root_, {}, other.root_));
+  }
+
+  // Split into the longest prefix whose measure does not satisfy pred, and
+  // the rest. If pred never holds, the whole tree is the prefix.
+  template <typename Pred>
+  [[nodiscard]] std::pair<FingerTree, FingerTree> Split(
+      const Pred& pred) const {
+    if (IsEmpty() || !pred(Measured())) return {*this, Empty()};
+    auto split = SplitLevel(pred, Measure::Identity(), root_);
+    return {FingerTree(std::move(split.left_)),
+            FingerTree(PushFront(std::move(split.item_), split.right_))};
+  }
+
+  // First element at which pred holds for the measure of the prefix
+  // ending with it. Throws std::out_of_range if there is none.
+  template <typename Pred>
+  [[nodiscard]] const T& Find(const Pred& pred) const {
+    if (IsEmpty() || !pred(Measured()))
+      throw std::out_of_range("No element satisfies the predicate");
+    Value acc = Measure::Identity();
+    return AsElement(FindLevel(pred, acc, root_))->value_;
+  }
+
+  [[nodiscard]] int Length() const
+    requires SizedMeasure<Measure>
+  {
+    return Measure::Size(Measured());
+  }
+
+  // Indexing: 0-based. Throws std::out_of_range if index invalid.
+  [[nodiscard]] const T& Index(const int index) const
+    requires SizedMeasure<Measure>
+  {
+    if (index < 0 || index >= Length())
+      throw std::out_of_range("Index out of range");
+    return Find(
+        [index](const Value& value) { return Measure::Size(value) > index; });
+  }
+
+  // Split into the first index elements and the rest. Throws
+  // std::out_of_range unless 0 <= index <= Length().
+  [[nodiscard]] std::pair<FingerTree, FingerTree> SplitAt(
+      const int index) const
+    requires SizedMeasure<Measure>
+  {
+    if (index < 0 || index > Length())
+      throw std::out_of_range("Index out of range");
+    return Split(
+        [index](const Value& value) { return Measure::Size(value) > index; });
+  }
+
+  // Read-only forward iterator. It keeps a stack of the levels and nodes
+  // still to visit, so each step is amortised O(1). The tree must outlive
+  // it.
+  class const_iterator {
+    struct Pending {
+      const void* ptr_;
+      bool is_level_;
+    };
+    std::vector<Pending> stack_;
+    const Element* current_ = nullptr;
+    std::ptrdiff_t index_ = 0;
+
+    explicit const_iterator(const Level* root) {
+      if (root != nullptr) stack_.push_back({root, true});
+      Advance();
+    }
+    friend class FingerTree;
+
+    void PushItems(const ItemPtr* items, const int count) {
+      for (int i = count - 1; i >= 0; i--)
+        stack_.push_back({items[i].get(), false});
+    }
+
+    // Expand pending work until the next element is on top.
+    void Advance() {
+      current_ = nullptr;
+      while (!stack_.empty()) {
+        const Pending pending = stack_.back();
+        stack_.pop_back();
+        if (pending.is_level_) {
+          const Level* level = static_cast<const Level*>(pending.ptr_);
+          PushItems(level->suffix_.items_.data(), level->suffix_.count_);
+          if (level->middle_ != nullptr)
+            stack_.push_back({level->middle_.get(), true});
+          PushItems(level->prefix_.items_.data(), level->prefix_.count_);
+          continue;
+        }
+        const Item* item = static_cast<const Item*>(pending.ptr_);
+        if (item->arity_ == 0) {
+          current_ = AsElement(item);
+          return;
+        }
+        PushItems(AsNode(item)->children_.data(), item->arity_);
+      }
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return current_->value_; }
+    pointer operator->() const { return &current_->value_; }
+
+    const_iterator& operator++() {
+      index_++;
+      Advance();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    // The same element can occur at several positions (e.g. in
+    // t.Append(t)), so positions are compared as well.
+    bool operator==(const const_iterator& other) const {
+      return current_ == other.current_ &&
+             (current_ == nullptr || index_ == other.index_);
+    }
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator(root_.get());
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+};
+
+#endif  // FINGERTREE_FINGER_TREE_H
@@ -0,0 +1,94 @@
+#ifndef HASH_HASH_H
+#define HASH_HASH_H
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Hashing shared by the sequence types.
+//
+// A sequence x_0 .. x_{n-1} hashes to the polynomial
+//   sum of HashElement(x_i) * kHashMultiplier^(n - 1 - i)   (mod 2^64),
+// finalised together with n. The polynomial can be evaluated front to back in
+// one pass, but it also splits at any point: the hash of a ++ b is
+// hash(a) * kHashMultiplier^|b| + hash(b). That lets LinkedList cache the
+// hash of every suffix it has seen and lets Deque combine its two halves
+// without building a list.
+
+// Opt in to caching per-node hashes for LinkedList<T>, e.g.
+//   template <>
+//   inline constexpr bool kCacheListHash<std::string> = true;
+// Each node then carries one extra word holding the hash of the list starting
+// at it, filled in the first time that list is hashed. Hashing a list that
+// only differs from an already hashed one by a prefix costs O(prefix).
+template <typename T>
+inline constexpr bool kCacheListHash = false;
+
+template <typename T>
+concept Hashable = requires(const T& value) {
+  { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+};
+
+// Odd, so multiplying by it is a bijection mod 2^64.
+inline constexpr std::uint64_t kHashMultiplier = 0x9e3779b97f4a7c15ULL;
+
+// splitmix64 finaliser. std::hash is the identity for integers in common
+// standard libraries, which would make the polynomial easy to collide.
+constexpr std::uint64_t MixHash(std::uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+template <Hashable T>
+std::uint64_t HashElement(const T& value) {
+  return MixHash(static_cast<std::uint64_t>(std::hash<T>{}(value)));
+}
+
+// kHashMultiplier^n, by repeated squaring.
+constexpr std::uint64_t HashPower(int n) {
+  std::uint64_t result = 1;
+  std::uint64_t base = kHashMultiplier;
+  for (; n > 0; n >>= 1) {
+    if ((n & 1) != 0) result *= base;
+    base *= base;
+  }
+  return result;
+}
+
+// Turn a polynomial over length elements into the value std::hash returns.
+constexpr std::size_t FinalizeHash(const std::uint64_t polynomial,
+                                   const int length) {
+  return static_cast<std::size_t>(
+      MixHash(polynomial ^ static_cast<std::uint64_t>(length)));
+}
+
+// Per-node storage for a cached polynomial, where 0 means "not computed yet".
+// A polynomial that really is 0 is simply recomputed each time. The value
+// only depends on immutable data, so racing writers store the same value and
+// relaxed ordering is enough. The disabled slot is empty and takes no space
+// under [[no_unique_address]].
+template <bool kEnabled>
+struct HashSlot {
+  [[nodiscard]] static std::uint64_t Load() { return 0; }
+  static void Store(std::uint64_t /*polynomial*/) {}
+};
+
+template <>
+struct HashSlot<true> {
+  mutable std::atomic<std::uint64_t> polynomial_ = 0;
+
+  [[nodiscard]] std::uint64_t Load() const {
+    return polynomial_.load(std::memory_order_relaxed);
+  }
+  void Store(const std::uint64_t polynomial) const {
+    polynomial_.store(polynomial, std::memory_order_relaxed);
+  }
+};
+
+#endif  // HASH_HASH_H
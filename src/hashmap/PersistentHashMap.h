@@ -0,0 +1,425 @@
+#ifndef HASHMAP_PERSISTENT_HASH_MAP_H
+#define HASHMAP_PERSISTENT_HASH_MAP_H
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "sharing/Sharing.h"
+
+// Persistent hash map: a hash array mapped trie (Bagwell) with the compact
+// node layout of CHAMP (Steindorfer and Vinju).
+// Representation:
+// - Each node consumes kBits bits of the key's hash and has up to kWidth
+//   slots. Two bitmaps say which slots are used: datamap_ marks slots that
+//   hold an entry inline, nodemap_ marks slots that hold a child node. The
+//   entries and children themselves are stored densely, so a slot's position
+//   is the popcount of the bits below it.
+// - Keys whose hashes agree on all their bits end up in a collision node
+//   below the last level, which keeps its entries in a plain array.
+// - An empty map has no root.
+// Design notes:
+// - Insert and Erase copy the path from the root to the affected node,
+//   O(log32 n) nodes, and share everything else with the original map.
+// - Erase keeps the trie canonical: a node left with a single entry and no
+//   children is inlined into its parent, so the shape of a map only depends
+//   on its contents.
+// - Builder is the transient, bulk-load mode. It edits nodes in place when
+//   it is their only owner and copies them first otherwise, so turning a map
+//   into a builder and back never changes the original.
+// - Nodes are allocated with Alloc and reference counted according to
+//   Sharing, exactly like LinkedList nodes (see sharing/Sharing.h). Alloc,
+//   Hash and KeyEqual are default-constructed on demand, so they must be
+//   stateless.
+// - At(key) throws std::out_of_range when key is absent.
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Alloc = std::allocator<std::pair<const K, V>>,
+          typename Sharing = AtomicSharing>
+class PersistentHashMap {
+ public:
+  using Entry = std::pair<K, V>;
+
+ private:
+  static constexpr int kBits = 5;
+  static constexpr int kWidth = 1 << kBits;
+  static constexpr int kHashBits = sizeof(std::size_t) * CHAR_BIT;
+  // Levels of bitmap nodes plus the collision level.
+  static constexpr int kMaxDepth = (kHashBits + kBits - 1) / kBits + 1;
+
+  struct Node;
+  using NodePtr = typename Sharing::template Ptr<Node, Alloc>;
+  template <typename U>
+  using Rebound =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+  struct Node {
+    std::uint32_t datamap_ = 0;
+    std::uint32_t nodemap_ = 0;
+    std::vector<Entry, Rebound<Entry>> entries_;
+    std::vector<NodePtr, Rebound<NodePtr>> children_;
+  };
+
+  NodePtr root_;
+  int size_ = 0;
+
+  PersistentHashMap(NodePtr root, const int size)
+      : root_(std::move(root)), size_(size) {}
+
+  template <typename... Args>
+  static NodePtr MakeNode(Args&&... args) {
+    return Sharing::template Make<Node, Alloc>(std::forward<Args>(args)...);
+  }
+
+  static std::size_t HashOf(const K& key) { return Hash{}(key); }
+
+  static std::uint32_t Bit(const std::size_t hash, const int shift) {
+    return std::uint32_t{1} << ((hash >> shift) & (kWidth - 1));
+  }
+
+  // Position of bit's slot among the slots set in map.
+  static int Position(const std::uint32_t map, const std::uint32_t bit) {
+    return std::popcount(map & (bit - 1));
+  }
+
+  static const V* Lookup(const Node* node, const std::size_t hash,
+                         const K& key) {
+    for (int shift = 0; node != nullptr; shift += kBits) {
+      if (shift >= kHashBits) {
+        for (const Entry& entry : node->entries_)
+          if (KeyEqual{}(entry.first, key)) return &entry.second;
+        return nullptr;
+      }
+      const std::uint32_t bit = Bit(hash, shift);
+      if ((node->datamap_ & bit) != 0) {
+        const Entry& entry = node->entries_[Position(node->datamap_, bit)];
+        return KeyEqual{}(entry.first, key) ? &entry.second : nullptr;
+      }
+      if ((node->nodemap_ & bit) == 0) return nullptr;
+      node = node->children_[Position(node->nodemap_, bit)].get();
+    }
+    return nullptr;
+  }
+
+  // The node in slot, ready to be modified: edited in place when transient
+  // and slot is its only owner, and replaced by a copy otherwise.
+  static Node& Editable(NodePtr& slot, const bool transient) {
+    if (!transient || slot.use_count() != 1) slot = MakeNode(*slot);
+    return *slot;
+  }
+
+  // Node holding a and b, which are known to differ, from shift down.
+  static NodePtr Pair(Entry a, const std::size_t a_hash, Entry b,
+                      const std::size_t b_hash, const int shift) {
+    NodePtr node = MakeNode();
+    if (shift >= kHashBits) {
+      node->entries_.reserve(2);
+      node->entries_.push_back(std::move(a));
+      node->entries_.push_back(std::move(b));
+      return node;
+    }
+    const std::uint32_t a_bit = Bit(a_hash, shift);
+    const std::uint32_t b_bit = Bit(b_hash, shift);
+    if (a_bit == b_bit) {
+      node->nodemap_ = a_bit;
+      node->children_.push_back(
+          Pair(std::move(a), a_hash, std::move(b), b_hash, shift + kBits));
+      return node;
+    }
+    node->datamap_ = a_bit | b_bit;
+    node->entries_.reserve(2);
+    if (a_bit > b_bit) std::swap(a, b);
+    node->entries_.push_back(std::move(a));
+    node->entries_.push_back(std::move(b));
+    return node;
+  }
+
+  // Insert or replace entry below slot, which is non-null. Returns true if
+  // the map grew.
+  static bool Assoc(NodePtr& slot, const std::size_t hash, const int shift,
+                    Entry&& entry, const bool transient) {
+    Node& node = Editable(slot, transient);
+    if (shift >= kHashBits) {
+      for (Entry& existing : node.entries_) {
+        if (KeyEqual{}(existing.first, entry.first)) {
+          existing.second = std::move(entry.second);
+          return false;
+        }
+      }
+      node.entries_.push_back(std::move(entry));
+      return true;
+    }
+    const std::uint32_t bit = Bit(hash, shift);
+    if ((node.nodemap_ & bit) != 0) {
+      return Assoc(node.children_[Position(node.nodemap_, bit)], hash,
+                   shift + kBits, std::move(entry), transient);
+    }
+    const int position = Position(node.datamap_, bit);
+    if ((node.datamap_ & bit) == 0) {
+      node.entries_.insert(node.entries_.begin() + position, std::move(entry));
+      node.datamap_ |= bit;
+      return true;
+    }
+    Entry& existing = node.entries_[position];
+    if (KeyEqual{}(existing.first, entry.first)) {
+      existing.second = std::move(entry.second);
+      return false;
+    }
+    // Two keys share this slot now: push both one level down.
+    const std::size_t existing_hash = HashOf(existing.first);
+    NodePtr child = Pair(std::move(existing), existing_hash, std::move(entry),
+                         hash, shift + kBits);
+    node.entries_.erase(node.entries_.begin() + position);
+    node.datamap_ ^= bit;
+    node.children_.insert(
+        node.children_.begin() + Position(node.nodemap_, bit),
+        std::move(child));
+    node.nodemap_ |= bit;
+    return true;
+  }
+
+  // Remove key, which is known to be present below slot.
+  static void Dissoc(NodePtr& slot, const std::size_t hash, const int shift,
+                     const K& key, const bool transient) {
+    Node& node = Editable(slot, transient);
+    if (shift >= kHashBits) {
+      for (auto it = node.entries_.begin(); it != node.entries_.end(); ++it) {
+        if (KeyEqual{}(it->first, key)) {
+          node.entries_.erase(it);
+          return;
+        }
+      }
+      return;
+    }
+    const std::uint32_t bit = Bit(hash, shift);
+    if ((node.datamap_ & bit) != 0) {
+      node.entries_.erase(node.entries_.begin() +
+                          Position(node.datamap_, bit));
+      node.datamap_ ^= bit;
+      return;
+    }
+    const auto child = node.children_.begin() + Position(node.nodemap_, bit);
+    Dissoc(*child, hash, shift + kBits, key, transient);
+    // Dissoc left the child editable, so its last entry can be moved out.
+    if ((*child)->children_.empty() && (*child)->entries_.size() == 1) {
+      Entry last = std::move((*child)->entries_.front());
+      node.children_.erase(child);
+      node.nodemap_ ^= bit;
+      node.entries_.insert(
+          node.entries_.begin() + Position(node.datamap_, bit),
+          std::move(last));
+      node.datamap_ |= bit;
+    }
+  }
+
+  static void Insert(NodePtr& root, int& size, Entry&& entry,
+                     const bool transient) {
+    const std::size_t hash = HashOf(entry.first);
+    if (root == nullptr) {
+      root = MakeNode();
+      root->datamap_ = Bit(hash, 0);
+      root->entries_.push_back(std::move(entry));
+      size = 1;
+      return;
+    }
+    if (Assoc(root, hash, 0, std::move(entry), transient)) size++;
+  }
+
+  static bool Erase(NodePtr& root, int& size, const K& key,
+                    const bool transient) {
+    const std::size_t hash = HashOf(key);
+    if (Lookup(root.get(), hash, key) == nullptr) return false;
+    if (--size == 0) {
+      root = nullptr;
+      return true;
+    }
+    Dissoc(root, hash, 0, key, transient);
+    return true;
+  }
+
+ public:
+  PersistentHashMap() = default;
+
+  [[nodiscard]] static PersistentHashMap Empty() {
+    return PersistentHashMap();
+  }
+
+  // O(1).
+  [[nodiscard]] int Size() const { return size_; }
+
+  [[nodiscard]] bool IsEmpty() const { return size_ == 0; }
+
+  // Pointer to the value stored for key, or nullptr. The value lives as long
+  // as any map sharing its node does.
+  [[nodiscard]] const V* Find(const K& key) const {
+    return Lookup(root_.get(), HashOf(key), key);
+  }
+
+  [[nodiscard]] bool Contains(const K& key) const {
+    return Find(key) != nullptr;
+  }
+
+  // Throws std::out_of_range if key is absent.
+  [[nodiscard]] const V& At(const K& key) const {
+    const V* value = Find(key);
+    if (value == nullptr) throw std::out_of_range("Key not found");
+    return *value;
+  }
+
+  // Map with key bound to value, replacing any previous binding.
+  [[nodiscard]] PersistentHashMap Insert(K key, V value) const {
+    NodePtr root = root_;
+    int size = size_;
+    Insert(root, size, Entry(std::move(key), std::move(value)), false);
+    return PersistentHashMap(std::move(root), size);
+  }
+
+  // Map without key. Returns a map sharing this one's root, copying nothing,
+  // if key is absent.
+  [[nodiscard]] PersistentHashMap Erase(const K& key) const {
+    NodePtr root = root_;
+    int size = size_;
+    Erase(root, size, key, false);
+    return PersistentHashMap(std::move(root), size);
+  }
+
+  // Forward iterator over the entries, in hash order. Like the list
+  // iterators it holds raw node pointers, so the map must outlive it.
+  class const_iterator {
+    struct Frame {
+      const Node* node_;
+      std::size_t next_child_;
+    };
+    std::array<Frame, kMaxDepth> stack_{};
+    int depth_ = 0;
+    const Node* node_ = nullptr;
+    std::size_t entry_ = 0;
+
+    explicit const_iterator(const Node* root) {
+      if (root == nullptr) return;
+      stack_[depth_++] = {root, 0};
+      node_ = root;
+      if (root->entries_.empty()) NextNode();
+    }
+    friend class PersistentHashMap;
+
+    // Depth-first walk to the next node that holds entries. Canonical
+    // tries have no empty subtrees, so this always finds one or ends.
+    void NextNode() {
+      entry_ = 0;
+      while (depth_ > 0) {
+        Frame& top = stack_[depth_ - 1];
+        if (top.next_child_ == top.node_->children_.size()) {
+          depth_--;
+          continue;
+        }
+        const Node* child = top.node_->children_[top.next_child_++].get();
+        stack_[depth_++] = {child, 0};
+        if (!child->entries_.empty()) {
+          node_ = child;
+          return;
+        }
+      }
+      node_ = nullptr;
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = const Entry&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return node_->entries_[entry_]; }
+    pointer operator->() const { return &node_->entries_[entry_]; }
+
+    const_iterator& operator++() {
+      if (++entry_ == node_->entries_.size()) NextNode();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return node_ == other.node_ && entry_ == other.entry_;
+    }
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator(root_.get());
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+
+  // Transient map for bulk construction and batches of updates. Nodes it
+  // creates are edited in place until Build(), which freezes them into a
+  // persistent map without copying and leaves the builder empty. Nodes
+  // shared with an existing map are copied on first write, so that map is
+  // never affected. Move-only, like LinkedList::Builder.
+  class Builder {
+    NodePtr root_;
+    int size_ = 0;
+
+   public:
+    Builder() = default;
+    // Start from the contents of map.
+    explicit Builder(const PersistentHashMap& map)
+        : root_(map.root_), size_(map.size_) {}
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+    Builder(Builder&& other) noexcept
+        : root_(std::move(other.root_)), size_(std::exchange(other.size_, 0)) {
+      other.root_ = nullptr;
+    }
+    Builder& operator=(Builder&& other) noexcept {
+      if (this == &other) return *this;
+      root_ = std::move(other.root_);
+      other.root_ = nullptr;
+      size_ = std::exchange(other.size_, 0);
+      return *this;
+    }
+    ~Builder() = default;
+
+    [[nodiscard]] int Size() const { return size_; }
+
+    [[nodiscard]] bool IsEmpty() const { return size_ == 0; }
+
+    [[nodiscard]] const V* Find(const K& key) const {
+      return Lookup(root_.get(), HashOf(key), key);
+    }
+
+    Builder& Insert(K key, V value) {
+      PersistentHashMap::Insert(root_, size_,
+                                Entry(std::move(key), std::move(value)), true);
+      return *this;
+    }
+
+    Builder& Erase(const K& key) {
+      PersistentHashMap::Erase(root_, size_, key, true);
+      return *this;
+    }
+
+    // Freeze into a persistent map and reset the builder.
+    [[nodiscard]] PersistentHashMap Build() {
+      PersistentHashMap map(std::move(root_), std::exchange(size_, 0));
+      root_ = nullptr;
+      return map;
+    }
+  };
+};
+
+#endif  // HASHMAP_PERSISTENT_HASH_MAP_H
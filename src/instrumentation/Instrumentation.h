@@ -0,0 +1,215 @@
+#ifndef INSTRUMENTATION_INSTRUMENTATION_H
+#define INSTRUMENTATION_INSTRUMENTATION_H
+
+#include <cstdint>
+
+#ifdef IMMUTABLE_INSTRUMENTATION
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#endif
+
+// Opt-in counters for the hot paths of LinkedList and Deque, to tell node
+// allocations, path copying and rebalancing apart when latency regresses.
+// Design notes:
+// - Compiled in only when IMMUTABLE_INSTRUMENTATION is defined (CMake option
+//   ENABLE_INSTRUMENTATION). Otherwise every hook is an empty inline
+//   function and the readers return zeros, so instrumented code costs
+//   nothing and callers need no #ifdefs of their own.
+// - Each thread counts into its own block, written only by that thread with
+//   relaxed loads and stores, so counting takes no locked instructions and
+//   keeps cache lines thread-private. Blocks are registered globally so that
+//   GlobalInstrumentation() can sum them, and the counts of exited threads
+//   are folded into a retired total.
+// - Counters mean:
+//   - node_allocations_: nodes allocated, whatever the reason.
+//   - nodes_copied_: nodes rebuilt from an existing node, as path copying
+//     in Append, Init, SplitAt, Reverse and WithSharing does. Uniquely
+//     owned nodes that a consuming (&&) operation relinks do not count.
+//   - nodes_shared_: nodes of an existing list that a new list reuses as its
+//     tail.
+//   - rebalances_ / rebalanced_elements_: Deque rebalances, and the total
+//     length of the deques that were rebalanced.
+//   - max_traversal_depth_: the longest walk down a list by Index or Last.
+struct InstrumentationCounters {
+  std::uint64_t node_allocations_ = 0;
+  std::uint64_t nodes_copied_ = 0;
+  std::uint64_t nodes_shared_ = 0;
+  std::uint64_t rebalances_ = 0;
+  std::uint64_t rebalanced_elements_ = 0;
+  std::uint64_t max_traversal_depth_ = 0;
+};
+
+#ifdef IMMUTABLE_INSTRUMENTATION
+
+inline constexpr bool kInstrumentationEnabled = true;
+
+// Storage behind the hooks below; not meant to be used directly.
+class InstrumentationRegistry {
+ public:
+  enum Counter : std::size_t {
+    kNodeAllocations,
+    kNodesCopied,
+    kNodesShared,
+    kRebalances,
+    kRebalancedElements,
+    kMaxTraversalDepth,
+    kCounterCount,
+  };
+  using Values = std::array<std::uint64_t, kCounterCount>;
+
+  // One thread's counters. Only the owning thread writes them.
+  class Block {
+    std::array<std::atomic<std::uint64_t>, kCounterCount> values_{};
+
+   public:
+    Block() { Instance().Register(this); }
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+    ~Block() { Instance().Retire(this); }
+
+    void Add(const Counter counter, const std::uint64_t n) {
+      auto& value = values_[counter];
+      value.store(value.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+    }
+    void Max(const Counter counter, const std::uint64_t n) {
+      auto& value = values_[counter];
+      if (n > value.load(std::memory_order_relaxed))
+        value.store(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Values Load() const {
+      Values values;
+      for (std::size_t i = 0; i < kCounterCount; i++)
+        values[i] = values_[i].load(std::memory_order_relaxed);
+      return values;
+    }
+    void Reset() {
+      for (auto& value : values_) value.store(0, std::memory_order_relaxed);
+    }
+  };
+
+  static InstrumentationRegistry& Instance() {
+    static InstrumentationRegistry registry;
+    return registry;
+  }
+
+  static Block& ThisThread() {
+    thread_local Block block;
+    return block;
+  }
+
+  static void Combine(Values& total, const Values& values) {
+    for (std::size_t i = 0; i < kCounterCount; i++) {
+      total[i] = i == kMaxTraversalDepth ? std::max(total[i], values[i])
+                                         : total[i] + values[i];
+    }
+  }
+
+  [[nodiscard]] Values Global() {
+    const std::lock_guard lock(mutex_);
+    Values total = retired_;
+    for (const Block* block : blocks_) Combine(total, block->Load());
+    return total;
+  }
+
+  // Blocks are only reset, not owned, so this races benignly with threads
+  // that are counting: an increment in flight may survive the reset.
+  void Reset() {
+    const std::lock_guard lock(mutex_);
+    retired_ = Values{};
+    for (Block* block : blocks_) block->Reset();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<Block*> blocks_;
+  Values retired_{};
+
+  void Register(Block* block) {
+    const std::lock_guard lock(mutex_);
+    blocks_.push_back(block);
+  }
+
+  void Retire(Block* block) {
+    const std::lock_guard lock(mutex_);
+    Combine(retired_, block->Load());
+    std::erase(blocks_, block);
+  }
+};
+
+inline InstrumentationCounters ToCounters(
+    const InstrumentationRegistry::Values& values) {
+  using Registry = InstrumentationRegistry;
+  InstrumentationCounters counters;
+  counters.node_allocations_ = values[Registry::kNodeAllocations];
+  counters.nodes_copied_ = values[Registry::kNodesCopied];
+  counters.nodes_shared_ = values[Registry::kNodesShared];
+  counters.rebalances_ = values[Registry::kRebalances];
+  counters.rebalanced_elements_ = values[Registry::kRebalancedElements];
+  counters.max_traversal_depth_ = values[Registry::kMaxTraversalDepth];
+  return counters;
+}
+
+// Counters of the calling thread.
+inline InstrumentationCounters ThreadInstrumentation() {
+  return ToCounters(InstrumentationRegistry::ThisThread().Load());
+}
+
+// Counters summed over every thread, including threads that have exited.
+// max_traversal_depth_ is the maximum over threads.
+inline InstrumentationCounters GlobalInstrumentation() {
+  return ToCounters(InstrumentationRegistry::Instance().Global());
+}
+
+// Zero the counters of every thread.
+inline void ResetInstrumentation() {
+  InstrumentationRegistry::Instance().Reset();
+}
+
+// Hooks called by the data structures.
+inline void CountNodeAllocation() {
+  InstrumentationRegistry::ThisThread().Add(
+      InstrumentationRegistry::kNodeAllocations, 1);
+}
+inline void CountNodesCopied(const int n) {
+  if (n > 0)
+    InstrumentationRegistry::ThisThread().Add(
+        InstrumentationRegistry::kNodesCopied, n);
+}
+inline void CountNodesShared(const int n) {
+  if (n > 0)
+    InstrumentationRegistry::ThisThread().Add(
+        InstrumentationRegistry::kNodesShared, n);
+}
+inline void CountRebalance(const int elements) {
+  auto& block = InstrumentationRegistry::ThisThread();
+  block.Add(InstrumentationRegistry::kRebalances, 1);
+  block.Add(InstrumentationRegistry::kRebalancedElements, elements);
+}
+inline void RecordTraversalDepth(const int depth) {
+  InstrumentationRegistry::ThisThread().Max(
+      InstrumentationRegistry::kMaxTraversalDepth, depth);
+}
+
+#else
+
+inline constexpr bool kInstrumentationEnabled = false;
+
+inline InstrumentationCounters ThreadInstrumentation() { return {}; }
+inline InstrumentationCounters GlobalInstrumentation() { return {}; }
+inline void ResetInstrumentation() {}
+
+inline void CountNodeAllocation() {}
+inline void CountNodesCopied(int /*n*/) {}
+inline void CountNodesShared(int /*n*/) {}
+inline void CountRebalance(int /*elements*/) {}
+inline void RecordTraversalDepth(int /*depth*/) {}
+
+#endif  // IMMUTABLE_INSTRUMENTATION
+
+#endif  // INSTRUMENTATION_INSTRUMENTATION_H
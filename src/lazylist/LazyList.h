@@ -0,0 +1,298 @@
+#ifndef LAZYLIST_LAZY_LIST_H
+#define LAZYLIST_LAZY_LIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "linkedlist/LinkedList.h"
+
+// Immutable lazy list (stream) with memoised, thread-safe suspensions.
+// Representation:
+// - A list is a shared cell that is either already evaluated or holds a
+//   thunk. Evaluating it yields either nothing (the empty list) or a head
+//   and a tail, where the tail is another lazy list.
+// Design notes:
+// - Each cell is evaluated at most once, even when several threads force it
+//   at the same time (std::call_once). Every version that shares the cell
+//   sees the memoised result, which is what persistent data structures with
+//   lazy rebuilding (see RealTimeDeque) rely on for their bounds.
+// - Append, Map, Filter, Take, Zip and FromList are incremental: they return
+//   at once and do the work for an element only when that element is
+//   forced. Drop, Length and ToList are strict and force the cells they
+//   pass.
+// - A thunk that throws leaves its cell unevaluated, so forcing it again
+//   retries.
+// - Long chains of evaluated cells are released in a loop, like LinkedList,
+//   so dropping a long list uses constant stack.
+// - Head and Tail throw std::runtime_error on an empty list, as LinkedList
+//   does.
+template <typename T>
+class LazyList {
+  template <typename>
+  friend class LazyList;
+
+ public:
+  // What a cell evaluates to: nothing, or a head and a tail.
+  using Value = std::optional<std::pair<T, LazyList>>;
+
+ private:
+  struct Cell {
+    std::once_flag once_;
+    std::atomic<bool> forced_;
+    std::function<Value()> thunk_;
+    Value value_;
+
+    explicit Cell(std::function<Value()> thunk)
+        : forced_(false), thunk_(std::move(thunk)) {}
+    explicit Cell(Value value) : forced_(true), value_(std::move(value)) {}
+  };
+  std::shared_ptr<Cell> cell_;
+
+  explicit LazyList(std::shared_ptr<Cell> cell) : cell_(std::move(cell)) {}
+
+ public:
+  LazyList() : cell_(std::make_shared<Cell>(Value())) {}
+  LazyList(const LazyList& other) = default;
+  LazyList(LazyList&& other) noexcept = default;
+  LazyList& operator=(const LazyList& other) = default;
+  LazyList& operator=(LazyList&& other) noexcept = default;
+
+  // Unlink evaluated cells we solely own in a loop, like ~LinkedList.
+  ~LazyList() {
+    while (cell_ != nullptr && cell_.use_count() == 1 &&
+           cell_->forced_.load(std::memory_order_acquire) &&
+           cell_->value_.has_value()) {
+      std::shared_ptr<Cell> next = std::move(cell_->value_->second.cell_);
+      cell_ = std::move(next);
+    }
+  }
+
+  [[nodiscard]] static LazyList Empty() { return LazyList(); }
+
+  // A list whose first cell is computed by thunk when it is first forced.
+  [[nodiscard]] static LazyList Lazy(std::function<Value()> thunk) {
+    return LazyList(std::make_shared<Cell>(std::move(thunk)));
+  }
+
+  // Prepend element to this list; the new cell is already evaluated.
+  [[nodiscard]] LazyList Cons(const T& element) const {
+    return LazyList(
+        std::make_shared<Cell>(Value(std::in_place, element, *this)));
+  }
+  [[nodiscard]] LazyList Cons(T&& element) const {
+    return LazyList(std::make_shared<Cell>(
+        Value(std::in_place, std::move(element), *this)));
+  }
+
+  [[nodiscard]] static LazyList Single(const T& element) {
+    return Empty().Cons(element);
+  }
+
+  // The infinite list seed, fn(seed), fn(fn(seed)), ...
+  template <typename Fn>
+  [[nodiscard]] static LazyList Iterate(T seed, Fn fn) {
+    return Lazy([seed = std::move(seed), fn]() -> Value {
+      T next = fn(seed);
+      return Value(std::in_place, seed, Iterate(std::move(next), fn));
+    });
+  }
+
+  // Lazy copy of list: each element is copied into its cell when that cell
+  // is first forced, and the rest of list is kept alive until then.
+  template <typename Alloc, typename Sharing>
+  [[nodiscard]] static LazyList FromList(LinkedList<T, Alloc, Sharing> list) {
+    return Lazy([list = std::move(list)]() -> Value {
+      if (list.IsEmpty()) return std::nullopt;
+      return Value(std::in_place, list.Head(), FromList(list.Tail()));
+    });
+  }
+
+  // Evaluate the first cell (once) and return what it holds.
+  const Value& Force() const {
+    Cell* cell = cell_.get();
+    if (!cell->forced_.load(std::memory_order_acquire)) {
+      std::call_once(cell->once_, [cell] {
+        cell->value_ = cell->thunk_();
+        cell->thunk_ = nullptr;
+        cell->forced_.store(true, std::memory_order_release);
+      });
+    }
+    return cell->value_;
+  }
+
+  // True once the first cell has been evaluated. Never forces anything.
+  [[nodiscard]] bool IsForced() const {
+    return cell_->forced_.load(std::memory_order_acquire);
+  }
+
+  // Forces the first cell.
+  [[nodiscard]] bool IsEmpty() const { return !Force().has_value(); }
+
+  // Throws std::runtime_error if the list is empty.
+  [[nodiscard]] const T& Head() const {
+    const Value& value = Force();
+    if (!value.has_value())
+      throw std::runtime_error("Cannot call head on an empty list");
+    return value->first;
+  }
+
+  // Throws std::runtime_error if the list is empty.
+  [[nodiscard]] LazyList Tail() const {
+    const Value& value = Force();
+    if (!value.has_value())
+      throw std::runtime_error("Cannot call tail on an empty list");
+    return value->second;
+  }
+
+  // Strict: forces and counts every cell, and never ends on an infinite list.
+  [[nodiscard]] int Length() const {
+    int length = 0;
+    for (auto it = begin(); it != end(); ++it) length++;
+    return length;
+  }
+
+  // Lazy concatenation: other is not touched until this list is exhausted.
+  [[nodiscard]] LazyList Append(const LazyList& other) const {
+    return Lazy([self = *this, other]() -> Value {
+      const Value& value = self.Force();
+      if (!value.has_value()) return other.Force();
+      return Value(std::in_place, value->first, value->second.Append(other));
+    });
+  }
+
+  // Lazily apply fn to each element as it is forced.
+  template <typename Fn>
+  [[nodiscard]] LazyList<std::invoke_result_t<Fn&, const T&>> Map(
+      Fn fn) const {
+    using Mapped = LazyList<std::invoke_result_t<Fn&, const T&>>;
+    return Mapped::Lazy([self = *this, fn]() -> typename Mapped::Value {
+      const Value& value = self.Force();
+      if (!value.has_value()) return std::nullopt;
+      return typename Mapped::Value(std::in_place, fn(value->first),
+                                    value->second.Map(fn));
+    });
+  }
+
+  // Lazily keep the elements satisfying pred. Forcing a cell skips, in a
+  // loop, past every rejected element before the next accepted one.
+  template <typename Pred>
+  [[nodiscard]] LazyList Filter(Pred pred) const {
+    return Lazy([self = *this, pred]() -> Value {
+      for (LazyList cur = self;;) {
+        const Value& value = cur.Force();
+        if (!value.has_value()) return std::nullopt;
+        if (pred(value->first))
+          return Value(std::in_place, value->first,
+                       value->second.Filter(pred));
+        cur = LazyList(value->second);
+      }
+    });
+  }
+
+  // Lazily take the first n elements.
+  [[nodiscard]] LazyList Take(const int n) const {
+    return Lazy([n, self = *this]() -> Value {
+      if (n <= 0) return std::nullopt;
+      const Value& value = self.Force();
+      if (!value.has_value()) return std::nullopt;
+      return Value(std::in_place, value->first, value->second.Take(n - 1));
+    });
+  }
+
+  // Strictly drop the first n elements, forcing them. Stops early at the end
+  // of the list.
+  [[nodiscard]] LazyList Drop(int n) const {
+    LazyList list = *this;
+    while (n > 0) {
+      const Value& value = list.Force();
+      if (!value.has_value()) break;
+      list = LazyList(value->second);
+      n--;
+    }
+    return list;
+  }
+
+  // Lazily pair up elements; the result is as long as the shorter list.
+  template <typename U>
+  [[nodiscard]] LazyList<std::pair<T, U>> Zip(const LazyList<U>& other) const {
+    using Zipped = LazyList<std::pair<T, U>>;
+    return Zipped::Lazy([self = *this, other]() -> typename Zipped::Value {
+      const Value& value = self.Force();
+      if (!value.has_value()) return std::nullopt;
+      const auto& other_value = other.Force();
+      if (!other_value.has_value()) return std::nullopt;
+      return typename Zipped::Value(
+          std::in_place, std::pair<T, U>(value->first, other_value->first),
+          value->second.Zip(other_value->second));
+    });
+  }
+
+  // Strict: forces every cell, and never ends on an infinite list.
+  template <typename List = LinkedList<T>>
+  [[nodiscard]] List ToList() const {
+    typename List::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  // Forward iterator that forces cells as it reaches them. It keeps the
+  // cell it points at alive, so it may outlive the list it came from.
+  class const_iterator {
+    // Empty while at the end, so that end() needs no cell.
+    std::optional<LazyList> list_;
+
+    explicit const_iterator(const LazyList& list) {
+      if (!list.IsEmpty()) list_ = list;
+    }
+    friend class LazyList;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return list_->Force()->first; }
+    pointer operator->() const { return &**this; }
+
+    const_iterator& operator++() {
+      const LazyList& next = list_->Force()->second;
+      if (next.IsEmpty()) {
+        list_.reset();
+      } else {
+        list_ = LazyList(next);
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    // Iterators are equal when they point at the same cell.
+    bool operator==(const const_iterator& other) const {
+      if (!list_.has_value() || !other.list_.has_value())
+        return list_.has_value() == other.list_.has_value();
+      return list_->cell_ == other.list_->cell_;
+    }
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const { return const_iterator(*this); }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+};
+
+#endif  // LAZYLIST_LAZY_LIST_H
@@ -1,8 +1,27 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "hash/Hash.h"
+#include "instrumentation/Instrumentation.h"
+#include "sharing/Sharing.h"
+
+template <typename T, typename Alloc, typename Sharing>
+class Deque;
+template <typename T>
+class SnapshotWriter;
+template <typename List, auto... Values>
+class StaticList;
 
 // Immutable singly-linked list with structural sharing.
 // Representation:
@@ -12,35 +31,195 @@
 // - All public operations are functional: they return new lists and preserve
 //   existing lists (structural sharing via shared_ptr).
 // - Many operations are recursive for clarity rather than performance.
+// - Every node caches the length of the list starting at it, so Length() and
+//   IsSingle() are O(1).
+// - Destruction is iterative: dropping the last reference to a long chain
+//   unlinks uniquely-owned nodes in a loop, so it uses constant stack.
 // - Methods that require a non-empty list throw std::runtime_error when
 // violated.
-template <typename T>
+// - Nodes are allocated with Alloc. Allocators are default-constructed on
+//   demand, so Alloc must be stateless or keep its state outside the instance
+//   (see PoolAllocator).
+// - Sharing selects how nodes are reference counted (see sharing/Sharing.h).
+//   The default, AtomicSharing, is safe to share between threads.
+//   IntrusiveSharing is too, with smaller nodes and list handles.
+// - ==, <=> and Hash() stop walking as soon as both sides reach the same
+//   node, since the rest is then shared. Nodes can also cache hashes (see
+//   kCacheListHash in hash/Hash.h).
+template <typename T, typename Alloc = std::allocator<T>,
+          typename Sharing = AtomicSharing>
 class LinkedList {
+  template <typename, typename, typename>
+  friend class LinkedList;
+  template <typename, typename, typename>
+  friend class Deque;
+  template <typename>
+  friend class SnapshotWriter;
+  template <typename, auto...>
+  friend class StaticList;
+
  private:
-  struct Node {
+  // With an intrusive Sharing policy the reference count is the first field
+  // (see NodeHeader in sharing/Sharing.h) and size_ completes its word, so
+  // a node of 8-byte elements takes 24 bytes rather than the 32 it would
+  // with the count in a separate word.
+  struct Node : Sharing::NodeHeader {
+    // Number of elements in the list starting at this node. Nodes are never
+    // mutated while they are shared, so the cached size stays valid for every
+    // list that shares this node. Consuming (&&) operations relink nodes
+    // that only the consumed list owns, updating it as they go.
+    int size_;
     T value_;
     LinkedList next_;
-    Node(const T& value, const LinkedList& next) : value_(value), next_(next) {}
+    // Polynomial hash of the list starting at this node, when enabled.
+    [[no_unique_address]] HashSlot<kCacheListHash<T>> hash_;
+    Node(const T& value, const LinkedList& next)
+        : size_(next.Length() + 1), value_(value), next_(next) {}
+    // Used while building a chain front to back, when next_ is filled in
+    // later but the final size is already known.
+    Node(const T& value, const LinkedList& next, const int size)
+        : size_(size), value_(value), next_(next) {}
+    // Construct the element in place from args, e.g. by moving it in.
+    template <typename... Args>
+    Node(std::in_place_t /*tag*/, LinkedList next, const int size,
+         Args&&... args)
+        : size_(size),
+          value_(std::forward<Args>(args)...),
+          next_(std::move(next)) {}
+    // A node of a StaticList, in static storage, followed by next.
+    constexpr Node(const ImmortalTag tag, const T& value, Node* next,
+                   const int size)
+        : Sharing::NodeHeader(tag),
+          size_(size),
+          value_(value),
+          next_(tag, next) {}
     // Move and copy constructors
-    Node(const Node& other) : value_(other.value_), next_(other.next_) {}
+    Node(const Node& other)
+        : size_(other.size_), value_(other.value_), next_(other.next_) {}
     Node(Node&& other) noexcept
-        : value_(std::move(other.value_)), next_(std::move(other.next_)) {}
+        : size_(other.size_),
+          value_(std::move(other.value_)),
+          next_(std::move(other.next_)) {}
     // Move and copy assignments
     Node& operator=(const Node& other) {
       if (this == &other) return *this;
       value_ = other.value_;
+      size_ = other.size_;
       next_ = other.next_;
       return *this;
     }
     Node& operator=(Node&& other) noexcept {
       if (this == &other) return *this;
       value_ = std::move(other.value_);
+      size_ = other.size_;
       next_ = std::move(other.next_);
       return *this;
     }
   };
+  using NodePtr = typename Sharing::template Ptr<Node, Alloc>;
+
   // If value == nullptr then the list is empty
-  std::shared_ptr<Node> value_;
+  NodePtr value_;
+
+  // The list starting at an immortal node, or the empty list if node is
+  // null.
+  constexpr LinkedList(const ImmortalTag /*tag*/, Node* node)
+      : value_(Sharing::template Immortal<Node, Alloc>(node)) {}
+
+  template <typename... Args>
+  static NodePtr MakeNode(Args&&... args) {
+    CountNodeAllocation();
+    return Sharing::template Make<Node, Alloc>(std::forward<Args>(args)...);
+  }
+
+  // Wrap already-constructed arguments into a new head node in front of next.
+  template <typename... Args>
+  static LinkedList MakeCons(LinkedList next, Args&&... args) {
+    LinkedList list;
+    const int size = next.Length() + 1;
+    CountNodesShared(size - 1);
+    list.value_ = MakeNode(std::in_place, std::move(next), size,
+                           std::forward<Args>(args)...);
+    return list;
+  }
+
+  // True if this list is the only owner of its head node. Nodes further down
+  // are only uniquely owned if every node before them is too.
+  [[nodiscard]] bool OwnsHead() const {
+    return value_ != nullptr && value_.use_count() == 1;
+  }
+
+  // Detach the head node of a list that solely owns it (see OwnsHead), so
+  // that a consuming operation can relink it, and advance this list to the
+  // node's tail. The node is left with an empty next_ and no cached hash.
+  NodePtr TakeHead() {
+    NodePtr node = std::move(value_);
+    value_ = std::move(node->next_.value_);
+    node->hash_.Store(0);
+    return node;
+  }
+
+  // Polynomial hash of the elements (see hash/Hash.h), before finalising.
+  // With cached hashes this walks only up to the first node whose hash is
+  // already known and fills in the nodes before it on the way back.
+  [[nodiscard]] std::uint64_t PolynomialHash() const {
+    std::uint64_t polynomial = 0;
+    if constexpr (!kCacheListHash<T>) {
+      for (const T& element : *this)
+        polynomial = polynomial * kHashMultiplier + HashElement(element);
+    } else {
+      std::vector<const Node*> pending;
+      const Node* cur = value_.get();
+      for (; cur != nullptr; cur = cur->next_.value_.get()) {
+        polynomial = cur->hash_.Load();
+        if (polynomial != 0) break;
+        pending.push_back(cur);
+      }
+      std::uint64_t power = HashPower(cur == nullptr ? 0 : cur->size_);
+      for (auto node = pending.rbegin(); node != pending.rend(); ++node) {
+        polynomial += HashElement((*node)->value_) * power;
+        power *= kHashMultiplier;
+        (*node)->hash_.Store(polynomial);
+      }
+    }
+    return polynomial;
+  }
+
+  // Chain of fresh nodes built front to back. Each node is linked after the
+  // previous one and must already carry its final size.
+  struct Chain {
+    LinkedList head_;
+    Node* tail_ = nullptr;
+
+    void Link(NodePtr node) {
+      Node* raw = node.get();
+      if (tail_ == nullptr) {
+        head_.value_ = std::move(node);
+      } else {
+        tail_->next_.value_ = std::move(node);
+      }
+      tail_ = raw;
+    }
+
+    // Finish the chain with rest as the shared tail of its last node.
+    LinkedList Release(LinkedList rest) {
+      if (tail_ == nullptr) return rest;
+      CountNodesShared(rest.Length());
+      tail_->next_ = std::move(rest);
+      tail_ = nullptr;
+      return std::move(head_);
+    }
+  };
+
+  // Utils.h splits lists node by node.
+  template <typename U, typename A, typename S>
+  friend std::pair<LinkedList<U, A, S>, LinkedList<U, A, S>> SplitAt(
+      int n, LinkedList<U, A, S> list);
+  template <typename U, typename A, typename S>
+  friend std::pair<LinkedList<U, A, S>, LinkedList<U, A, S>> SplitAndReverse(
+      int n, LinkedList<U, A, S> list);
+  template <typename U, typename A, typename S>
+  friend LinkedList<U, A, S> Reverse(LinkedList<U, A, S> list);
 
  public:
   // Copy and move constructors / assignments preserve structural sharing.
@@ -60,40 +239,73 @@ class LinkedList {
     return *this;
   }
 
+  // Without this, each Node would destroy its next_ from inside its own
+  // destructor, recursing once per element. Instead, while this list is the
+  // sole owner of the current node, detach its tail before releasing it. The
+  // loop stops at the first node that is still shared, so shared tails stay
+  // alive for their other owners.
+  ~LinkedList() {
+    while (value_ != nullptr && value_.use_count() == 1) {
+      NodePtr next = std::move(value_->next_.value_);
+      value_ = std::move(next);
+    }
+  }
+
   LinkedList() : value_(nullptr) {}
 
   LinkedList(T element, LinkedList next)
-      : value_(std::make_shared<Node>(element, next)) {}
+      : value_(MakeNode(std::in_place, next, next.Length() + 1,
+                        std::move(element))) {
+    CountNodesShared(next.Length());
+  }
 
   // Return true if list is nullptr or represents an empty node.
   [[nodiscard]] bool IsEmpty() const { return value_ == nullptr; }
 
   // Return head value. Throws std::runtime_error if list is null/empty.
-  [[nodiscard]] T Head() const {
+  // The reference stays valid for as long as any list sharing the node does.
+  [[nodiscard]] const T& Head() const {
     if (IsEmpty())
       throw std::runtime_error("Cannot call head on an empty list");
     return value_->value_;
   }
 
   // Return tail pointer. Throws std::runtime_error if list is null/empty.
-  [[nodiscard]] LinkedList Tail() const {
+  [[nodiscard]] LinkedList Tail() const& {
     if (IsEmpty())
       throw std::runtime_error("Cannot call tail on an empty list");
     return value_->next_;
   }
 
+  // Tail consuming this list: the tail is moved out of the head node, without
+  // touching reference counts, when this list was its only owner.
+  [[nodiscard]] LinkedList Tail() && {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call tail on an empty list");
+    if (!OwnsHead()) return value_->next_;
+    (void)TakeHead();
+    return std::move(*this);
+  }
+
+  // Split into head and tail, consuming this list. The head is moved out
+  // when this list was its node's only owner and copied otherwise. Throws
+  // std::runtime_error if list is null/empty.
+  [[nodiscard]] std::pair<T, LinkedList> Uncons() && {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call uncons on an empty list");
+    const NodePtr node = std::move(value_);
+    if (node.use_count() == 1)
+      return {std::move(node->value_), std::move(node->next_)};
+    return {node->value_, node->next_};
+  }
+
   // True if list contains exactly one element.
-  [[nodiscard]] bool IsSingle() const { return !IsEmpty() && Tail().IsEmpty(); }
+  [[nodiscard]] bool IsSingle() const { return Length() == 1; }
 
-  // Iterative length computation; nullptr/empty treated as 0.
+  // O(1): every node caches the length of the list starting at it.
   [[nodiscard]] int Length() const {
-    int count = 0;
-    Node* cur = this->value_.get();
-    while (cur != nullptr) {
-      count++;
-      cur = cur->next_.value_.get();
-    }
-    return count;
+    if (IsEmpty()) return 0;
+    return value_->size_;
   }
 
   // Create an empty list node.
@@ -101,7 +313,16 @@ class LinkedList {
 
   // Prepend element (functional): returns new list with element as head.
   [[nodiscard]] LinkedList Cons(const T& element) const {
-    return LinkedList(element, *this);
+    return MakeCons(*this, element);
+  }
+  [[nodiscard]] LinkedList Cons(T&& element) const {
+    return MakeCons(*this, std::move(element));
+  }
+
+  // Prepend an element constructed in place from args.
+  template <typename... Args>
+  [[nodiscard]] LinkedList EmplaceCons(Args&&... args) const {
+    return MakeCons(*this, std::forward<Args>(args)...);
   }
 
   // Use the += operator to be an infix cons as it is right associative unlike +
@@ -110,40 +331,85 @@ class LinkedList {
                                              const LinkedList& list) {
     return list.Cons(element);
   }
+  [[nodiscard]] friend LinkedList operator+=(T&& element,
+                                             const LinkedList& list) {
+    return list.Cons(std::move(element));
+  }
 
   // Single-element list helper.
   [[nodiscard]] static LinkedList Single(const T& element) {
     return element += Empty();
   }
+  [[nodiscard]] static LinkedList Single(T&& element) {
+    return std::move(element) += Empty();
+  }
+
+  template <typename... Args>
+  [[nodiscard]] static LinkedList EmplaceSingle(Args&&... args) {
+    return MakeCons(Empty(), std::forward<Args>(args)...);
+  }
 
   // Snoc: append an element to the end (functional). Builds a new list.
-  [[nodiscard]] LinkedList Snoc(const T& element) const {
+  // Called on an rvalue, it goes through the consuming Append and relinks
+  // the nodes this list solely owns instead of copying them.
+  [[nodiscard]] LinkedList Snoc(const T& element) const& {
     return this->Append(Single(element));
   }
+  [[nodiscard]] LinkedList Snoc(const T& element) && {
+    return std::move(*this).Append(Single(element));
+  }
+  [[nodiscard]] LinkedList Snoc(T&& element) const& {
+    return this->Append(Single(std::move(element)));
+  }
+  [[nodiscard]] LinkedList Snoc(T&& element) && {
+    return std::move(*this).Append(Single(std::move(element)));
+  }
+
+  template <typename... Args>
+  [[nodiscard]] LinkedList EmplaceSnoc(Args&&... args) const& {
+    return this->Append(EmplaceSingle(std::forward<Args>(args)...));
+  }
+  template <typename... Args>
+  [[nodiscard]] LinkedList EmplaceSnoc(Args&&... args) && {
+    return std::move(*this).Append(
+        EmplaceSingle(std::forward<Args>(args)...));
+  }
 
   // Init: return all but the last element. Throws on null/empty.
-  [[nodiscard]] LinkedList Init() const {
-    LinkedList head{};
-    Node* tail = nullptr;
-    Node* cur = this->value_.get();
-    while (cur != nullptr && cur->next_.value_ != nullptr) {
-      if (tail == nullptr) {
-        // First element of the list
-        head.value_ = std::make_shared<Node>(cur->value_, LinkedList());
-        tail = head.value_.get();
-      } else {
-        tail->next_ = LinkedList(cur->value_, LinkedList());
-        tail = tail->next_.value_.get();
-      }
-      cur = cur->next_.value_.get();
+  [[nodiscard]] LinkedList Init() const& {
+    Chain chain;
+    int remaining = Length() - 1;
+    CountNodesCopied(remaining);
+    for (Node* cur = this->value_.get(); remaining > 0;
+         cur = cur->next_.value_.get())
+      chain.Link(MakeNode(cur->value_, LinkedList(), remaining--));
+    return chain.Release(LinkedList());
+  }
+
+  // Init consuming this list: the nodes it solely owns are relinked with
+  // their sizes decremented, and only the nodes after the first shared one
+  // are copied. A uniquely-owned list allocates nothing.
+  [[nodiscard]] LinkedList Init() && {
+    Chain chain;
+    int remaining = Length() - 1;
+    LinkedList rest = std::move(*this);
+    while (remaining > 0 && rest.OwnsHead()) {
+      NodePtr node = rest.TakeHead();
+      node->size_ = remaining--;
+      chain.Link(std::move(node));
     }
-    return head;
+    CountNodesCopied(remaining);
+    for (Node* cur = rest.value_.get(); remaining > 0;
+         cur = cur->next_.value_.get())
+      chain.Link(MakeNode(cur->value_, LinkedList(), remaining--));
+    return chain.Release(LinkedList());
   }
 
   // Return last element. Throws on null/empty.
-  [[nodiscard]] T Last() const {
+  [[nodiscard]] const T& Last() const {
     if (IsEmpty())
       throw std::runtime_error("Cannot call last on an empty list");
+    RecordTraversalDepth(Length());
     Node* cur = this->value_.get();
     while (!cur->next_.IsEmpty()) {
       cur = cur->next_.value_.get();
@@ -153,37 +419,257 @@ class LinkedList {
 
   // Append (concatenate) two lists: returns a new list representing listA ++
   // listB.
-  [[nodiscard]] LinkedList Append(const LinkedList& other) const {
-    if (IsEmpty()) return other;
-    LinkedList head{};
-    Node* tail = nullptr;
-    Node* cur = this->value_.get();
-    while (cur != nullptr) {
-      if (tail == nullptr) {
-        // First element of the list
-        head.value_ = std::make_shared<Node>(cur->value_, LinkedList());
-        tail = head.value_.get();
-      } else {
-        tail->next_ = LinkedList(cur->value_, LinkedList());
-        tail = tail->next_.value_.get();
-      }
-      cur = cur->next_.value_.get();
+  [[nodiscard]] LinkedList Append(const LinkedList& other) const& {
+    Chain chain;
+    int remaining = Length() + other.Length();
+    CountNodesCopied(Length());
+    for (Node* cur = this->value_.get(); cur != nullptr;
+         cur = cur->next_.value_.get())
+      chain.Link(MakeNode(cur->value_, LinkedList(), remaining--));
+    return chain.Release(other);
+  }
+
+  // Append consuming this list: the nodes this list solely owns are relinked
+  // in place, with their sizes updated, rather than copied. Copying resumes
+  // from the first shared node, since everything after it is shared too. A
+  // uniquely-owned list therefore allocates nothing and copies no element.
+  [[nodiscard]] LinkedList Append(const LinkedList& other) && {
+    Chain chain;
+    int remaining = Length() + other.Length();
+    LinkedList rest = std::move(*this);
+    while (rest.OwnsHead()) {
+      NodePtr node = rest.TakeHead();
+      node->size_ = remaining--;
+      chain.Link(std::move(node));
     }
-    tail->next_ = other;
-    return head;
+    CountNodesCopied(rest.Length());
+    for (Node* cur = rest.value_.get(); cur != nullptr;
+         cur = cur->next_.value_.get())
+      chain.Link(MakeNode(cur->value_, LinkedList(), remaining--));
+    return chain.Release(other);
   }
 
   // Indexing: 0-based. Throws std::out_of_range if index invalid.
-  [[nodiscard]] T Index(int index) const {
-    if (index < 0) throw std::out_of_range("Index out of range");
+  [[nodiscard]] const T& Index(int index) const {
+    if (index < 0 || index >= Length())
+      throw std::out_of_range("Index out of range");
+    RecordTraversalDepth(index + 1);
     Node* cur = this->value_.get();
-    for (int i = 0; i < index; i++) {
-      if (cur == nullptr) throw std::out_of_range("Index out of range");
-      cur = cur->next_.value_.get();
-    }
-    if (cur == nullptr) throw std::out_of_range("Index out of range");
+    for (int i = 0; i < index; i++) cur = cur->next_.value_.get();
     return cur->value_;
   }
+
+  // All but the first n elements, sharing this list's nodes: O(n) steps and
+  // no copies. Throws std::out_of_range unless 0 <= n <= Length().
+  [[nodiscard]] LinkedList Drop(const int n) const {
+    if (n < 0 || n > Length()) throw std::out_of_range("Index out of range");
+    if (n == 0) return *this;
+    Node* cur = this->value_.get();
+    for (int i = 1; i < n; i++) cur = cur->next_.value_.get();
+    return cur->next_;
+  }
+
+  // Copy this list into one using a different sharing policy, e.g. to hand a
+  // LocalSharing list to another thread as an AtomicSharing one. O(n): nodes
+  // cannot be shared between policies.
+  template <typename OtherSharing>
+  [[nodiscard]] LinkedList<T, Alloc, OtherSharing> WithSharing() const {
+    using Other = LinkedList<T, Alloc, OtherSharing>;
+    typename Other::Chain chain;
+    int remaining = Length();
+    CountNodesCopied(remaining);
+    for (Node* cur = value_.get(); cur != nullptr;
+         cur = cur->next_.value_.get())
+      chain.Link(Other::MakeNode(cur->value_, Other(), remaining--));
+    return chain.Release(Other());
+  }
+
+  // Element-wise equality. O(1) for lists of different lengths; otherwise it
+  // compares elements up to the first node both lists share.
+  [[nodiscard]] friend bool operator==(const LinkedList& lhs,
+                                       const LinkedList& rhs)
+    requires std::equality_comparable<T>
+  {
+    if (lhs.Length() != rhs.Length()) return false;
+    // Equal lengths, so both walks reach a shared node or the end together.
+    for (const Node *a = lhs.value_.get(), *b = rhs.value_.get(); a != b;
+         a = a->next_.value_.get(), b = b->next_.value_.get()) {
+      const std::uint64_t a_hash = a->hash_.Load();
+      const std::uint64_t b_hash = b->hash_.Load();
+      if (a_hash != 0 && b_hash != 0 && a_hash != b_hash) return false;
+      if (!(a->value_ == b->value_)) return false;
+    }
+    return true;
+  }
+
+  // Lexicographic comparison, stopping early at the first shared node.
+  [[nodiscard]] friend auto operator<=>(const LinkedList& lhs,
+                                        const LinkedList& rhs)
+    requires std::three_way_comparable<T>
+  {
+    using Ordering = std::compare_three_way_result_t<T>;
+    const Node* a = lhs.value_.get();
+    const Node* b = rhs.value_.get();
+    for (; a != b; a = a->next_.value_.get(), b = b->next_.value_.get()) {
+      if (a == nullptr) return Ordering(std::strong_ordering::less);
+      if (b == nullptr) return Ordering(std::strong_ordering::greater);
+      if (const Ordering order = a->value_ <=> b->value_; order != 0)
+        return order;
+    }
+    return Ordering(std::strong_ordering::equal);
+  }
+
+  // Hash of the elements, consistent with ==: a Deque with the same elements
+  // hashes the same too. O(n), or O(prefix not hashed before) with cached
+  // hashes.
+  [[nodiscard]] std::size_t Hash() const
+    requires Hashable<T>
+  {
+    return FinalizeHash(PolynomialHash(), Length());
+  }
+
+  // Calls fn(node, bytes) for each node, front to back, where node identifies
+  // the node's allocation and bytes is its size (see kBlockBytes in
+  // sharing/Sharing.h). Stops once fn returns false, e.g. on reaching a
+  // suffix that has been counted before. Used by memory/MemoryStats.h.
+  template <typename Fn>
+  void ForEachNode(Fn fn) const {
+    constexpr std::size_t kBytes =
+        Sharing::template kBlockBytes<Node, Alloc>;
+    for (const Node* cur = value_.get(); cur != nullptr;
+         cur = cur->next_.value_.get())
+      if (!fn(static_cast<const void*>(cur), kBytes)) return;
+  }
+
+  // Read-only forward iterator over the elements. It holds a raw node
+  // pointer, so iterating touches no reference counts; the list it came from
+  // must outlive it.
+  class const_iterator {
+    const Node* node_ = nullptr;
+
+    explicit const_iterator(const Node* node) : node_(node) {}
+    friend class LinkedList;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return node_->value_; }
+    pointer operator->() const { return &node_->value_; }
+
+    const_iterator& operator++() {
+      node_ = node_->next_.value_.get();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    bool operator==(const const_iterator& other) const = default;
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator(value_.get());
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  // Transient builder for bulk construction. Nodes owned by a builder have
+  // not been published yet, so Snoc links them in place in O(1) instead of
+  // copying the prefix. Build() freezes the chain into an ordinary persistent
+  // list without copying it and leaves the builder empty.
+  // A builder is move-only: copying it would let two builders mutate the
+  // same unpublished nodes.
+  class Builder {
+    Chain chain_;
+    int length_ = 0;
+
+   public:
+    Builder() = default;
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+    Builder(Builder&& other) noexcept
+        : chain_{std::move(other.chain_.head_),
+                 std::exchange(other.chain_.tail_, nullptr)},
+          length_(std::exchange(other.length_, 0)) {}
+    Builder& operator=(Builder&& other) noexcept {
+      if (this == &other) return *this;
+      chain_.head_ = std::move(other.chain_.head_);
+      chain_.tail_ = std::exchange(other.chain_.tail_, nullptr);
+      length_ = std::exchange(other.length_, 0);
+      return *this;
+    }
+    ~Builder() = default;
+
+    [[nodiscard]] int Length() const { return length_; }
+
+    [[nodiscard]] bool IsEmpty() const { return length_ == 0; }
+
+    // Append element to the end in O(1).
+    Builder& Snoc(const T& element) {
+      // The size is provisional; Build() assigns the real sizes.
+      chain_.Link(MakeNode(element, LinkedList(), 0));
+      length_++;
+      return *this;
+    }
+    Builder& Snoc(T&& element) {
+      chain_.Link(MakeNode(std::in_place, LinkedList(), 0, std::move(element)));
+      length_++;
+      return *this;
+    }
+
+    // Prepend element in O(1).
+    Builder& Cons(const T& element) {
+      chain_.head_.value_ = MakeNode(element, chain_.head_, 0);
+      if (chain_.tail_ == nullptr) chain_.tail_ = chain_.head_.value_.get();
+      length_++;
+      return *this;
+    }
+
+    // Splice the contents of other onto the end of this builder in O(1).
+    Builder& Append(Builder&& other) {
+      if (other.IsEmpty()) return *this;
+      if (chain_.tail_ == nullptr) {
+        chain_.head_ = std::move(other.chain_.head_);
+      } else {
+        chain_.tail_->next_ = std::move(other.chain_.head_);
+      }
+      chain_.tail_ = std::exchange(other.chain_.tail_, nullptr);
+      length_ += std::exchange(other.length_, 0);
+      return *this;
+    }
+
+    // Freeze the chain into a persistent list and reset the builder.
+    [[nodiscard]] LinkedList Build() { return BuildOnto(LinkedList()); }
+
+    // Like Build(), but the chain is followed by rest, whose nodes are
+    // shared rather than copied.
+    [[nodiscard]] LinkedList BuildOnto(LinkedList rest) {
+      int remaining = length_ + rest.Length();
+      for (Node* cur = chain_.head_.value_.get(); cur != nullptr;
+           cur = cur->next_.value_.get())
+        cur->size_ = remaining--;
+      length_ = 0;
+      return chain_.Release(std::move(rest));
+    }
+  };
+};
+
+template <Hashable T, typename Alloc, typename Sharing>
+struct std::hash<LinkedList<T, Alloc, Sharing>> {
+  std::size_t operator()(const LinkedList<T, Alloc, Sharing>& list) const {
+    return list.Hash();
+  }
 };
 
 #endif  // LINKED_LIST_H
@@ -0,0 +1,85 @@
+#ifndef LINKEDLIST_STATIC_LIST_H
+#define LINKEDLIST_STATIC_LIST_H
+
+#include <memory>
+
+#include "linkedlist/LinkedList.h"
+#include "sharing/Sharing.h"
+
+// A LinkedList of values known at compile time, whose nodes live in static
+// storage instead of being allocated:
+//
+//   const auto primes = StaticList<LinkedList<int>, 2, 3, 5, 7>::Get();
+//   const auto more = primes.Cons(1);  // Allocates one node, shares four.
+//
+// Design notes:
+// - Get() returns an ordinary List, so runtime lists use a static list as a
+//   shared tail like any other: Cons, Append, Drop and the rest work
+//   unchanged and allocate only for the nodes they create.
+// - The nodes are immortal. They are never freed, not even at exit, so a
+//   static list may be used from other static objects' destructors. With
+//   IntrusiveSharing or LocalSharing they are constant-initialized into the
+//   program's data, so no code runs to build them. With AtomicSharing they
+//   are linked on the first Get(), which allocates nothing, and copies of
+//   the list then update no reference counts.
+// - Because the nodes are never uniquely owned, consuming (&&) operations
+//   copy them as they would any shared node.
+// - MakeStaticList<Values...>() is shorthand for a LinkedList<T> with the
+//   default policies, where T is the type of the values.
+template <typename List, auto... Values>
+class StaticList {
+  using Node = typename List::Node;
+  using T = decltype(Node::value_);
+
+  static constexpr int kLength = sizeof...(Values);
+
+  // Unions, so that the nodes and the list at their head are constructed
+  // explicitly and never destroyed.
+  union Slot {
+    Node node_;
+    constexpr Slot() {}
+    constexpr ~Slot() {}
+  };
+  union Head {
+    List list_;
+    constexpr explicit Head(Node* node) : list_(kImmortal, node) {}
+    constexpr ~Head() {}
+  };
+
+  struct Storage {
+    Slot slots_[kLength];
+    // Holds one of the references the head node was created with. Get()
+    // hands out counted copies of it.
+    Head head_;
+
+    constexpr explicit Storage(const T (&values)[kLength])
+        : head_(&slots_[0].node_) {
+      for (int i = kLength - 1; i >= 0; i--) {
+        Node* next = i + 1 < kLength ? &slots_[i + 1].node_ : nullptr;
+        std::construct_at(&slots_[i].node_, kImmortal, values[i], next,
+                          kLength - i);
+      }
+    }
+  };
+
+ public:
+  StaticList() = delete;
+
+  [[nodiscard]] static constexpr int Length() { return kLength; }
+
+  [[nodiscard]] static List Get() {
+    if constexpr (kLength == 0) {
+      return List();
+    } else {
+      static Storage storage({static_cast<T>(Values)...});
+      return storage.head_.list_;
+    }
+  }
+};
+
+template <auto First, decltype(First)... Rest>
+[[nodiscard]] LinkedList<decltype(First)> MakeStaticList() {
+  return StaticList<LinkedList<decltype(First)>, First, Rest...>::Get();
+}
+
+#endif  // LINKEDLIST_STATIC_LIST_H
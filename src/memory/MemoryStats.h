@@ -0,0 +1,97 @@
+#ifndef MEMORY_MEMORY_STATS_H
+#define MEMORY_MEMORY_STATS_H
+
+#include <cstddef>
+#include <ranges>
+#include <unordered_set>
+
+// Memory footprint of persistent versions, and how much of it they share.
+// Design notes:
+// - Works on any structure with ForEachNode(fn) (LinkedList, ChunkedList and
+//   Deque), which calls fn(node, bytes) with the address and size of each
+//   node allocation and stops once fn returns false.
+// - bytes_ counts each node's whole allocation, reference count or
+//   shared_ptr control block included, but not the allocator's own overhead
+//   nor any heap memory the elements own (e.g. a std::string's buffer).
+// - unique_bytes_ is what freeing this version would give back if the
+//   others given stayed alive: the nodes reachable from none of them.
+// - The walks record node addresses in a hash set. Measuring a version
+//   against others costs O(version + nodes the others reach): a walk over
+//   the others stops at the first node already seen, since everything after
+//   it has been counted.
+struct MemoryStats {
+  int nodes_ = 0;
+  std::size_t bytes_ = 0;
+  int unique_nodes_ = 0;
+  std::size_t unique_bytes_ = 0;
+
+  [[nodiscard]] std::size_t SharedBytes() const {
+    return bytes_ - unique_bytes_;
+  }
+
+  bool operator==(const MemoryStats& other) const = default;
+};
+
+template <typename S>
+concept NodeWalkable =
+    requires(const S& s, bool (*fn)(const void*, std::size_t)) {
+      s.ForEachNode(fn);
+    };
+
+// Footprint of version on its own, where every node counts as unique.
+template <NodeWalkable S>
+[[nodiscard]] MemoryStats MeasureMemory(const S& version) {
+  MemoryStats stats;
+  version.ForEachNode([&](const void* /*node*/, const std::size_t bytes) {
+    stats.nodes_++;
+    stats.bytes_ += bytes;
+    return true;
+  });
+  stats.unique_nodes_ = stats.nodes_;
+  stats.unique_bytes_ = stats.bytes_;
+  return stats;
+}
+
+// Footprint of version, and the part of it that none of others reaches.
+template <NodeWalkable S, std::ranges::input_range R>
+  requires NodeWalkable<std::ranges::range_value_t<R>>
+[[nodiscard]] MemoryStats MeasureMemory(const S& version, const R& others) {
+  std::unordered_set<const void*> reachable;
+  for (const auto& other : others)
+    other.ForEachNode([&](const void* node, std::size_t /*bytes*/) {
+      return reachable.insert(node).second;
+    });
+
+  MemoryStats stats;
+  version.ForEachNode([&](const void* node, const std::size_t bytes) {
+    stats.nodes_++;
+    stats.bytes_ += bytes;
+    if (!reachable.contains(node)) {
+      stats.unique_nodes_++;
+      stats.unique_bytes_ += bytes;
+    }
+    return true;
+  });
+  return stats;
+}
+
+// Combined footprint of a set of versions, counting each node once. All of
+// it is unique to the set.
+template <std::ranges::input_range R>
+  requires NodeWalkable<std::ranges::range_value_t<R>>
+[[nodiscard]] MemoryStats MeasureTotalMemory(const R& versions) {
+  std::unordered_set<const void*> seen;
+  MemoryStats stats;
+  for (const auto& version : versions)
+    version.ForEachNode([&](const void* node, const std::size_t bytes) {
+      if (!seen.insert(node).second) return false;
+      stats.nodes_++;
+      stats.bytes_ += bytes;
+      return true;
+    });
+  stats.unique_nodes_ = stats.nodes_;
+  stats.unique_bytes_ = stats.bytes_;
+  return stats;
+}
+
+#endif  // MEMORY_MEMORY_STATS_H
@@ -0,0 +1,154 @@
+#ifndef ORDEREDMAP_PERSISTENT_ORDERED_MAP_H
+#define ORDEREDMAP_PERSISTENT_ORDERED_MAP_H
+
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include "orderedmap/WeightBalancedTree.h"
+#include "sharing/Sharing.h"
+
+// Persistent ordered map on a weight-balanced tree (see
+// WeightBalancedTree.h).
+// - Insert, Erase, Find, Rank and Select are O(log n). Updates copy the path
+//   to the changed entry and share the rest with the original map.
+// - LowerBound, UpperBound and Range give ordered iterators, and Range is a
+//   std::ranges::forward_range like LinkedList, so range scans take
+//   O(log n + entries visited). CountRange counts in O(log n) without
+//   visiting anything.
+// - Union, Intersection and Difference are split/join based. Where both maps
+//   have a key, Union and Intersection keep this map's value.
+// - Nodes are allocated with Alloc and reference counted according to
+//   Sharing, as in LinkedList; Alloc and Compare must be stateless.
+// - At(key) throws std::out_of_range when key is absent, and Select(index)
+//   when index is.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<const K, V>>,
+          typename Sharing = AtomicSharing>
+class PersistentOrderedMap {
+ public:
+  using Entry = std::pair<K, V>;
+
+ private:
+  struct KeyOf {
+    const K& operator()(const Entry& entry) const { return entry.first; }
+  };
+  using Tree = WeightBalancedTree<K, Entry, KeyOf, Compare, Alloc, Sharing>;
+  using NodePtr = typename Tree::NodePtr;
+
+  NodePtr root_;
+
+  explicit PersistentOrderedMap(NodePtr root) : root_(std::move(root)) {}
+
+ public:
+  using const_iterator = typename Tree::const_iterator;
+  using iterator = const_iterator;
+  using EntryRange = std::ranges::subrange<const_iterator>;
+
+  PersistentOrderedMap() = default;
+
+  [[nodiscard]] static PersistentOrderedMap Empty() {
+    return PersistentOrderedMap();
+  }
+
+  // O(1).
+  [[nodiscard]] int Size() const { return Tree::Size(root_); }
+
+  [[nodiscard]] bool IsEmpty() const { return root_ == nullptr; }
+
+  // Pointer to the value stored for key, or nullptr.
+  [[nodiscard]] const V* Find(const K& key) const {
+    const Entry* entry = Tree::Find(root_.get(), key);
+    return entry == nullptr ? nullptr : &entry->second;
+  }
+
+  [[nodiscard]] bool Contains(const K& key) const {
+    return Tree::Find(root_.get(), key) != nullptr;
+  }
+
+  // Throws std::out_of_range if key is absent.
+  [[nodiscard]] const V& At(const K& key) const {
+    const V* value = Find(key);
+    if (value == nullptr) throw std::out_of_range("Key not found");
+    return *value;
+  }
+
+  // Map with key bound to value, replacing any previous binding.
+  [[nodiscard]] PersistentOrderedMap Insert(K key, V value) const {
+    return PersistentOrderedMap(
+        Tree::Insert(root_, Entry(std::move(key), std::move(value))));
+  }
+
+  // Map without key. Shares this map's root, copying nothing, if key is
+  // absent.
+  [[nodiscard]] PersistentOrderedMap Erase(const K& key) const {
+    if (!Contains(key)) return *this;
+    return PersistentOrderedMap(Tree::Erase(root_, key));
+  }
+
+  // Number of keys smaller than key, whether or not key is present.
+  [[nodiscard]] int Rank(const K& key) const {
+    return Tree::Rank(root_.get(), key);
+  }
+
+  // The entry with rank index. Throws std::out_of_range unless
+  // 0 <= index < Size().
+  [[nodiscard]] const Entry& Select(const int index) const {
+    return Tree::Select(root_.get(), index);
+  }
+
+  // Number of keys in [from, to).
+  [[nodiscard]] int CountRange(const K& from, const K& to) const {
+    if (!Compare{}(from, to)) return 0;
+    return Rank(to) - Rank(from);
+  }
+
+  // Entries with keys in [from, to), in order.
+  [[nodiscard]] EntryRange Range(const K& from, const K& to) const {
+    if (!Compare{}(from, to)) return EntryRange(end(), end());
+    return EntryRange(LowerBound(from), LowerBound(to));
+  }
+
+  // The entries with keys smaller than key, and those with greater keys.
+  [[nodiscard]] std::pair<PersistentOrderedMap, PersistentOrderedMap> Split(
+      const K& key) const {
+    typename Tree::Parts parts = Tree::Split(root_, key);
+    return {PersistentOrderedMap(std::move(parts.left_)),
+            PersistentOrderedMap(std::move(parts.right_))};
+  }
+
+  [[nodiscard]] PersistentOrderedMap Union(
+      const PersistentOrderedMap& other) const {
+    return PersistentOrderedMap(Tree::Union(root_, other.root_));
+  }
+
+  [[nodiscard]] PersistentOrderedMap Intersection(
+      const PersistentOrderedMap& other) const {
+    return PersistentOrderedMap(Tree::Intersection(root_, other.root_));
+  }
+
+  // Entries of this map whose keys are not in other.
+  [[nodiscard]] PersistentOrderedMap Difference(
+      const PersistentOrderedMap& other) const {
+    return PersistentOrderedMap(Tree::Difference(root_, other.root_));
+  }
+
+  [[nodiscard]] const_iterator begin() const {
+    return Tree::Begin(root_.get());
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+
+  // First entry whose key is not less than key.
+  [[nodiscard]] const_iterator LowerBound(const K& key) const {
+    return Tree::Bound(root_.get(), key, true);
+  }
+
+  // First entry whose key is greater than key.
+  [[nodiscard]] const_iterator UpperBound(const K& key) const {
+    return Tree::Bound(root_.get(), key, false);
+  }
+};
+
+#endif  // ORDEREDMAP_PERSISTENT_ORDERED_MAP_H
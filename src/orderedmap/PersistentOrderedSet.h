@@ -0,0 +1,120 @@
+#ifndef ORDEREDMAP_PERSISTENT_ORDERED_SET_H
+#define ORDEREDMAP_PERSISTENT_ORDERED_SET_H
+
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+#include "orderedmap/WeightBalancedTree.h"
+#include "sharing/Sharing.h"
+
+// Persistent ordered set: the keys-only counterpart of PersistentOrderedMap,
+// on the same weight-balanced tree and with the same complexity.
+// Select(index) throws std::out_of_range unless 0 <= index < Size().
+template <typename T, typename Compare = std::less<T>,
+          typename Alloc = std::allocator<T>, typename Sharing = AtomicSharing>
+class PersistentOrderedSet {
+  struct KeyOf {
+    const T& operator()(const T& element) const { return element; }
+  };
+  using Tree = WeightBalancedTree<T, T, KeyOf, Compare, Alloc, Sharing>;
+  using NodePtr = typename Tree::NodePtr;
+
+  NodePtr root_;
+
+  explicit PersistentOrderedSet(NodePtr root) : root_(std::move(root)) {}
+
+ public:
+  using const_iterator = typename Tree::const_iterator;
+  using iterator = const_iterator;
+  using ElementRange = std::ranges::subrange<const_iterator>;
+
+  PersistentOrderedSet() = default;
+
+  [[nodiscard]] static PersistentOrderedSet Empty() {
+    return PersistentOrderedSet();
+  }
+
+  // O(1).
+  [[nodiscard]] int Size() const { return Tree::Size(root_); }
+
+  [[nodiscard]] bool IsEmpty() const { return root_ == nullptr; }
+
+  [[nodiscard]] bool Contains(const T& element) const {
+    return Tree::Find(root_.get(), element) != nullptr;
+  }
+
+  // Returns a set sharing this one's root if element is already present.
+  [[nodiscard]] PersistentOrderedSet Insert(T element) const {
+    if (Contains(element)) return *this;
+    return PersistentOrderedSet(Tree::Insert(root_, std::move(element)));
+  }
+
+  // Returns a set sharing this one's root if element is absent.
+  [[nodiscard]] PersistentOrderedSet Erase(const T& element) const {
+    if (!Contains(element)) return *this;
+    return PersistentOrderedSet(Tree::Erase(root_, element));
+  }
+
+  // Number of elements smaller than element.
+  [[nodiscard]] int Rank(const T& element) const {
+    return Tree::Rank(root_.get(), element);
+  }
+
+  [[nodiscard]] const T& Select(const int index) const {
+    return Tree::Select(root_.get(), index);
+  }
+
+  // Number of elements in [from, to).
+  [[nodiscard]] int CountRange(const T& from, const T& to) const {
+    if (!Compare{}(from, to)) return 0;
+    return Rank(to) - Rank(from);
+  }
+
+  // Elements in [from, to), in order.
+  [[nodiscard]] ElementRange Range(const T& from, const T& to) const {
+    if (!Compare{}(from, to)) return ElementRange(end(), end());
+    return ElementRange(LowerBound(from), LowerBound(to));
+  }
+
+  // The elements smaller than element, and the greater ones.
+  [[nodiscard]] std::pair<PersistentOrderedSet, PersistentOrderedSet> Split(
+      const T& element) const {
+    typename Tree::Parts parts = Tree::Split(root_, element);
+    return {PersistentOrderedSet(std::move(parts.left_)),
+            PersistentOrderedSet(std::move(parts.right_))};
+  }
+
+  [[nodiscard]] PersistentOrderedSet Union(
+      const PersistentOrderedSet& other) const {
+    return PersistentOrderedSet(Tree::Union(root_, other.root_));
+  }
+
+  [[nodiscard]] PersistentOrderedSet Intersection(
+      const PersistentOrderedSet& other) const {
+    return PersistentOrderedSet(Tree::Intersection(root_, other.root_));
+  }
+
+  [[nodiscard]] PersistentOrderedSet Difference(
+      const PersistentOrderedSet& other) const {
+    return PersistentOrderedSet(Tree::Difference(root_, other.root_));
+  }
+
+  [[nodiscard]] const_iterator begin() const {
+    return Tree::Begin(root_.get());
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+
+  // First element not less than element.
+  [[nodiscard]] const_iterator LowerBound(const T& element) const {
+    return Tree::Bound(root_.get(), element, true);
+  }
+
+  // First element greater than element.
+  [[nodiscard]] const_iterator UpperBound(const T& element) const {
+    return Tree::Bound(root_.get(), element, false);
+  }
+};
+
+#endif  // ORDEREDMAP_PERSISTENT_ORDERED_SET_H
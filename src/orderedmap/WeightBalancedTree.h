@@ -0,0 +1,368 @@
+#ifndef ORDEREDMAP_WEIGHT_BALANCED_TREE_H
+#define ORDEREDMAP_WEIGHT_BALANCED_TREE_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "sharing/Sharing.h"
+
+// Persistent weight-balanced binary search tree shared by
+// PersistentOrderedMap and PersistentOrderedSet, which only differ in what
+// an entry is and how its key is found (KeyOf).
+// Representation:
+// - Every node caches the size of its subtree. A tree is balanced when
+//   neither child of a node is more than kDelta times the size of the other
+//   (Adams, "Efficient sets: a balancing act", with the parameters of
+//   Hirai and Yamamoto, "Balancing weight-balanced trees").
+// - The empty tree is null.
+// Complexity:
+// - Insert, Erase, Find, Rank and Select are O(log n), copying only the
+//   path from the root.
+// - Link (join) and Split are O(log n). Union, Intersection and Difference
+//   are built on them (Blelloch, Ferizovic and Sun, "Just join for parallel
+//   ordered sets") and take O(m log(n / m + 1)) for sizes m <= n, so
+//   merging a small batch into a big tree is cheap. Subtrees shared by both
+//   operands are recognised and reused as they are.
+// Design notes:
+// - Nodes are never modified after construction; rebalancing builds new
+//   nodes and shares the untouched subtrees.
+// - Recursion depth is bounded by the height, which is O(log n).
+template <typename Key, typename Entry, typename KeyOf, typename Compare,
+          typename Alloc, typename Sharing>
+class WeightBalancedTree {
+ public:
+  struct Node;
+  using NodePtr = typename Sharing::template Ptr<Node, Alloc>;
+
+  struct Node {
+    NodePtr left_;
+    NodePtr right_;
+    int size_;
+    Entry entry_;
+
+    template <typename E>
+    Node(NodePtr left, E&& entry, NodePtr right)
+        : left_(std::move(left)),
+          right_(std::move(right)),
+          size_(Size(left_) + Size(right_) + 1),
+          entry_(std::forward<E>(entry)) {}
+  };
+
+ private:
+  static constexpr int kDelta = 3;
+  static constexpr int kRatio = 2;
+
+  static const Key& KeyOfNode(const NodePtr& node) {
+    return KeyOf{}(node->entry_);
+  }
+  static bool Less(const Key& a, const Key& b) { return Compare{}(a, b); }
+
+  template <typename E>
+  static NodePtr MakeNode(NodePtr left, E&& entry, NodePtr right) {
+    return Sharing::template Make<Node, Alloc>(
+        std::move(left), std::forward<E>(entry), std::move(right));
+  }
+
+  static NodePtr RotateLeft(NodePtr left, const Entry& entry,
+                            const NodePtr& right) {
+    const NodePtr& inner = right->left_;
+    if (Size(inner) < kRatio * Size(right->right_)) {
+      return MakeNode(MakeNode(std::move(left), entry, inner), right->entry_,
+                      right->right_);
+    }
+    return MakeNode(MakeNode(std::move(left), entry, inner->left_),
+                    inner->entry_,
+                    MakeNode(inner->right_, right->entry_, right->right_));
+  }
+
+  static NodePtr RotateRight(const NodePtr& left, const Entry& entry,
+                             NodePtr right) {
+    const NodePtr& inner = left->right_;
+    if (Size(inner) < kRatio * Size(left->left_)) {
+      return MakeNode(left->left_, left->entry_,
+                      MakeNode(inner, entry, std::move(right)));
+    }
+    return MakeNode(MakeNode(left->left_, left->entry_, inner->left_),
+                    inner->entry_,
+                    MakeNode(inner->right_, entry, std::move(right)));
+  }
+
+  // Node of left, entry and right, whose sizes are at most one insertion or
+  // erasure away from balanced.
+  static NodePtr Balance(NodePtr left, const Entry& entry, NodePtr right) {
+    const int left_size = Size(left);
+    const int right_size = Size(right);
+    if (left_size + right_size > 1) {
+      if (right_size > kDelta * left_size)
+        return RotateLeft(std::move(left), entry, right);
+      if (left_size > kDelta * right_size)
+        return RotateRight(left, entry, std::move(right));
+    }
+    return MakeNode(std::move(left), entry, std::move(right));
+  }
+
+  static NodePtr InsertMin(const Entry& entry, const NodePtr& tree) {
+    if (tree == nullptr) return MakeNode(nullptr, entry, nullptr);
+    return Balance(InsertMin(entry, tree->left_), tree->entry_, tree->right_);
+  }
+
+  static NodePtr InsertMax(const Entry& entry, const NodePtr& tree) {
+    if (tree == nullptr) return MakeNode(nullptr, entry, nullptr);
+    return Balance(tree->left_, tree->entry_, InsertMax(entry, tree->right_));
+  }
+
+  struct Extracted {
+    const Entry* entry_;
+    NodePtr rest_;
+  };
+
+  // The smallest entry of a non-empty tree, and the tree without it.
+  static Extracted ExtractMin(const NodePtr& tree) {
+    if (tree->left_ == nullptr) return {&tree->entry_, tree->right_};
+    Extracted min = ExtractMin(tree->left_);
+    min.rest_ = Balance(std::move(min.rest_), tree->entry_, tree->right_);
+    return min;
+  }
+
+  static Extracted ExtractMax(const NodePtr& tree) {
+    if (tree->right_ == nullptr) return {&tree->entry_, tree->left_};
+    Extracted max = ExtractMax(tree->right_);
+    max.rest_ = Balance(tree->left_, tree->entry_, std::move(max.rest_));
+    return max;
+  }
+
+  // Concatenation of two trees that were siblings in a balanced tree.
+  static NodePtr Glue(const NodePtr& left, const NodePtr& right) {
+    if (left == nullptr) return right;
+    if (right == nullptr) return left;
+    if (Size(left) > Size(right)) {
+      const Extracted max = ExtractMax(left);
+      return Balance(max.rest_, *max.entry_, right);
+    }
+    const Extracted min = ExtractMin(right);
+    return Balance(left, *min.entry_, min.rest_);
+  }
+
+ public:
+  static int Size(const NodePtr& tree) {
+    return tree == nullptr ? 0 : tree->size_;
+  }
+
+  // Tree of left, entry and right, in that order, whatever their sizes.
+  static NodePtr Link(const NodePtr& left, const Entry& entry,
+                      const NodePtr& right) {
+    if (left == nullptr) return InsertMin(entry, right);
+    if (right == nullptr) return InsertMax(entry, left);
+    if (kDelta * Size(left) < Size(right))
+      return Balance(Link(left, entry, right->left_), right->entry_,
+                     right->right_);
+    if (kDelta * Size(right) < Size(left))
+      return Balance(left->left_, left->entry_,
+                     Link(left->right_, entry, right));
+    return MakeNode(left, entry, right);
+  }
+
+  // Concatenation of left and right, whose keys are all smaller.
+  static NodePtr Merge(const NodePtr& left, const NodePtr& right) {
+    if (left == nullptr) return right;
+    if (right == nullptr) return left;
+    if (kDelta * Size(left) < Size(right))
+      return Balance(Merge(left, right->left_), right->entry_, right->right_);
+    if (kDelta * Size(right) < Size(left))
+      return Balance(left->left_, left->entry_, Merge(left->right_, right));
+    return Glue(left, right);
+  }
+
+  struct Parts {
+    NodePtr left_;
+    // Entry with the split key, or nullptr. Owned by the split tree.
+    const Entry* found_;
+    NodePtr right_;
+  };
+
+  // The entries with keys smaller than key, the one equal to it, and the
+  // larger ones.
+  static Parts Split(const NodePtr& tree, const Key& key) {
+    if (tree == nullptr) return {nullptr, nullptr, nullptr};
+    if (Less(key, KeyOfNode(tree))) {
+      Parts parts = Split(tree->left_, key);
+      parts.right_ = Link(parts.right_, tree->entry_, tree->right_);
+      return parts;
+    }
+    if (Less(KeyOfNode(tree), key)) {
+      Parts parts = Split(tree->right_, key);
+      parts.left_ = Link(tree->left_, tree->entry_, parts.left_);
+      return parts;
+    }
+    return {tree->left_, &tree->entry_, tree->right_};
+  }
+
+  static const Entry* Find(const Node* node, const Key& key) {
+    while (node != nullptr) {
+      if (Less(key, KeyOf{}(node->entry_))) {
+        node = node->left_.get();
+      } else if (Less(KeyOf{}(node->entry_), key)) {
+        node = node->right_.get();
+      } else {
+        return &node->entry_;
+      }
+    }
+    return nullptr;
+  }
+
+  // Insert entry, replacing the entry with the same key if there is one.
+  template <typename E>
+  static NodePtr Insert(const NodePtr& tree, E&& entry) {
+    if (tree == nullptr)
+      return MakeNode(nullptr, std::forward<E>(entry), nullptr);
+    const Key& key = KeyOf{}(entry);
+    if (Less(key, KeyOfNode(tree)))
+      return Balance(Insert(tree->left_, std::forward<E>(entry)), tree->entry_,
+                     tree->right_);
+    if (Less(KeyOfNode(tree), key))
+      return Balance(tree->left_, tree->entry_,
+                     Insert(tree->right_, std::forward<E>(entry)));
+    return MakeNode(tree->left_, std::forward<E>(entry), tree->right_);
+  }
+
+  // Erase key, which is known to be present.
+  static NodePtr Erase(const NodePtr& tree, const Key& key) {
+    if (Less(key, KeyOfNode(tree)))
+      return Balance(Erase(tree->left_, key), tree->entry_, tree->right_);
+    if (Less(KeyOfNode(tree), key))
+      return Balance(tree->left_, tree->entry_, Erase(tree->right_, key));
+    return Glue(tree->left_, tree->right_);
+  }
+
+  // Number of keys smaller than key.
+  static int Rank(const Node* node, const Key& key) {
+    int rank = 0;
+    while (node != nullptr) {
+      if (Less(KeyOf{}(node->entry_), key)) {
+        rank += Size(node->left_) + 1;
+        node = node->right_.get();
+      } else {
+        node = node->left_.get();
+      }
+    }
+    return rank;
+  }
+
+  // Throws std::out_of_range unless 0 <= index < Size(tree).
+  static const Entry& Select(const Node* node, int index) {
+    if (node == nullptr || index < 0 || index >= node->size_)
+      throw std::out_of_range("Index out of range");
+    for (;;) {
+      const int left_size = Size(node->left_);
+      if (index == left_size) return node->entry_;
+      if (index < left_size) {
+        node = node->left_.get();
+      } else {
+        index -= left_size + 1;
+        node = node->right_.get();
+      }
+    }
+  }
+
+  // Entries of both trees; a's entry wins where both have a key.
+  static NodePtr Union(const NodePtr& a, const NodePtr& b) {
+    if (a == b || b == nullptr) return a;
+    if (a == nullptr) return b;
+    const Parts parts = Split(b, KeyOfNode(a));
+    return Link(Union(a->left_, parts.left_), a->entry_,
+                Union(a->right_, parts.right_));
+  }
+
+  // Entries of a whose keys are in b.
+  static NodePtr Intersection(const NodePtr& a, const NodePtr& b) {
+    if (a == b) return a;
+    if (a == nullptr || b == nullptr) return nullptr;
+    const Parts parts = Split(b, KeyOfNode(a));
+    NodePtr left = Intersection(a->left_, parts.left_);
+    NodePtr right = Intersection(a->right_, parts.right_);
+    if (parts.found_ == nullptr) return Merge(left, right);
+    return Link(left, a->entry_, right);
+  }
+
+  // Entries of a whose keys are not in b.
+  static NodePtr Difference(const NodePtr& a, const NodePtr& b) {
+    if (a == b || a == nullptr) return nullptr;
+    if (b == nullptr) return a;
+    const Parts parts = Split(a, KeyOfNode(b));
+    return Merge(Difference(parts.left_, b->left_),
+                 Difference(parts.right_, b->right_));
+  }
+
+  // In-order forward iterator. It keeps the path of nodes still to be
+  // visited, so the tree must outlive it, as with the list iterators.
+  class const_iterator {
+    // Top is the current node.
+    std::vector<const Node*> stack_;
+
+    void PushLeftSpine(const Node* node) {
+      for (; node != nullptr; node = node->left_.get()) stack_.push_back(node);
+    }
+    friend class WeightBalancedTree;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = const Entry&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return stack_.back()->entry_; }
+    pointer operator->() const { return &stack_.back()->entry_; }
+
+    const_iterator& operator++() {
+      const Node* node = stack_.back();
+      stack_.pop_back();
+      PushLeftSpine(node->right_.get());
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      if (stack_.empty() || other.stack_.empty())
+        return stack_.empty() == other.stack_.empty();
+      return stack_.back() == other.stack_.back();
+    }
+  };
+
+  static const_iterator Begin(const Node* root) {
+    const_iterator it;
+    it.PushLeftSpine(root);
+    return it;
+  }
+
+  // First entry whose key is not less than key (inclusive), or greater than
+  // key (!inclusive).
+  static const_iterator Bound(const Node* node, const Key& key,
+                              const bool inclusive) {
+    const_iterator it;
+    while (node != nullptr) {
+      const bool before = inclusive ? Less(KeyOf{}(node->entry_), key)
+                                    : !Less(key, KeyOf{}(node->entry_));
+      if (before) {
+        node = node->right_.get();
+      } else {
+        it.stack_.push_back(node);
+        node = node->left_.get();
+      }
+    }
+    return it;
+  }
+};
+
+#endif  // ORDEREDMAP_WEIGHT_BALANCED_TREE_H
@@ -0,0 +1,79 @@
+#ifndef SERIALIZATION_MAPPED_FILE_H
+#define SERIALIZATION_MAPPED_FILE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// Read-only memory mapping of a whole file (POSIX). Pages are loaded lazily
+// by the kernel as they are touched, so opening a multi-GB snapshot is cheap
+// and only the parts that are read cost I/O. The mapping is private and
+// read-only; the file should not be modified while it is mapped.
+// Throws std::system_error if the file cannot be opened or mapped.
+class MappedFile {
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+
+  void Unmap() {
+    if (data_ != nullptr) munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+ public:
+  explicit MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error(errno, std::generic_category(),
+                              "Cannot open " + path);
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+      const int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              "Cannot stat " + path);
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    // mmap rejects empty mappings; an empty file maps to an empty span.
+    if (size_ > 0) {
+      void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        const int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Cannot map " + path);
+      }
+      data_ = data;
+    }
+    close(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+  ~MappedFile() { Unmap(); }
+
+  // Page aligned, and valid for as long as this object is.
+  [[nodiscard]] std::span<const std::byte> Bytes() const {
+    return {static_cast<const std::byte*>(data_), size_};
+  }
+};
+
+#endif  // SERIALIZATION_MAPPED_FILE_H
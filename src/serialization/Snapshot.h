@@ -0,0 +1,409 @@
+#ifndef SERIALIZATION_SNAPSHOT_H
+#define SERIALIZATION_SNAPSHOT_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+// Compact binary snapshots of LinkedLists and Deques.
+//
+// File layout, in native byte order:
+// - SnapshotHeader.
+// - A root table of root_count_ node indices, one per list written.
+// - Padding up to alignof(SnapshotNode<T>).
+// - node_count_ SnapshotNode<T> records. Each record holds its element, the
+//   length of the list starting at it and the index of its next node.
+// Design notes:
+// - Every node is written once, however many lists share it, so the file
+//   keeps the DAG of shared tails rather than expanding it into copies.
+// - Records are written tail first: a node's next_ always refers to an
+//   earlier record, usually the one just before it. Loading is therefore one
+//   forward pass that keeps only the nodes referenced out of order, and
+//   snapshots can never contain cycles.
+// - Elements are stored as raw bytes, so T must be trivially copyable.
+//   Lists of pointers or strings need their own encoding on top.
+// - A Snapshot can either be loaded back into ordinary lists, preserving the
+//   sharing, or read in place through SnapshotList views. Combined with
+//   MappedFile this gives read-only access to a file without deserializing
+//   it; only the pages that are actually visited are read from disk.
+
+template <typename T>
+concept FlatValue =
+    std::is_trivially_copyable_v<T> && std::default_initializable<T>;
+
+struct SnapshotHeader {
+  std::array<char, 8> magic_;
+  std::uint32_t version_;
+  // kSnapshotByteOrder as written by the producer, to detect byte swapping.
+  std::uint32_t byte_order_;
+  std::uint32_t value_size_;
+  std::uint32_t value_align_;
+  std::uint64_t node_count_;
+  std::uint64_t root_count_;
+};
+
+inline constexpr std::array<char, 8> kSnapshotMagic = {'I', 'D', 'S', 'S',
+                                                       'N', 'A', 'P', '\0'};
+inline constexpr std::uint32_t kSnapshotVersion = 1;
+inline constexpr std::uint32_t kSnapshotByteOrder = 0x01020304;
+// Index of the node after the last one, and the root of an empty list.
+inline constexpr std::uint64_t kNoSnapshotNode =
+    std::numeric_limits<std::uint64_t>::max();
+// Set on nodes that are referenced other than from the record right after
+// them, i.e. roots and shared tails. Only those are remembered while loading.
+inline constexpr std::uint32_t kSnapshotNodeShared = 1;
+
+template <FlatValue T>
+struct SnapshotNode {
+  std::uint64_t next_;
+  std::int32_t length_;
+  std::uint32_t flags_;
+  T value_;
+};
+
+// Byte offset of the first node record.
+template <FlatValue T>
+constexpr std::size_t SnapshotNodesOffset(const std::uint64_t root_count) {
+  constexpr std::size_t kAlign = alignof(SnapshotNode<T>);
+  const std::size_t end =
+      sizeof(SnapshotHeader) + root_count * sizeof(std::uint64_t);
+  return (end + kAlign - 1) / kAlign * kAlign;
+}
+
+// Collects lists into a snapshot. Nodes shared between any of the lists
+// added, including the two halves of a deque or successive versions of one
+// structure, are written once. The lists only need to stay alive until
+// Write() returns.
+template <typename T>
+class SnapshotWriter {
+  static_assert(FlatValue<T>, "Snapshot elements must be trivially copyable");
+  using Record = SnapshotNode<T>;
+
+  std::vector<Record> nodes_;
+  std::vector<std::uint64_t> roots_;
+  std::unordered_map<const void*, std::uint64_t> indices_;
+
+ public:
+  // Add list as the next root and return its root number. O(nodes not
+  // written before).
+  template <typename Alloc, typename Sharing>
+  int Add(const LinkedList<T, Alloc, Sharing>& list) {
+    using Node = typename LinkedList<T, Alloc, Sharing>::Node;
+    std::vector<const Node*> fresh;
+    std::uint64_t next = kNoSnapshotNode;
+    for (const Node* cur = list.value_.get(); cur != nullptr;
+         cur = cur->next_.value_.get()) {
+      if (const auto found = indices_.find(cur); found != indices_.end()) {
+        next = found->second;
+        break;
+      }
+      fresh.push_back(cur);
+    }
+    for (auto node = fresh.rbegin(); node != fresh.rend(); ++node) {
+      const std::uint64_t index = nodes_.size();
+      if (next != kNoSnapshotNode && next + 1 != index)
+        nodes_[next].flags_ |= kSnapshotNodeShared;
+      // Value-initialised so that padding is written as zeros.
+      Record record = Record();
+      record.next_ = next;
+      record.length_ = (*node)->size_;
+      std::memcpy(&record.value_, &(*node)->value_, sizeof(T));
+      nodes_.push_back(record);
+      indices_.emplace(*node, index);
+      next = index;
+    }
+    if (next != kNoSnapshotNode) nodes_[next].flags_ |= kSnapshotNodeShared;
+    roots_.push_back(next);
+    return static_cast<int>(roots_.size()) - 1;
+  }
+
+  // Add both halves of deque and return the root number of its front. The
+  // back follows as the next root; Snapshot::LoadDeque reassembles them.
+  template <typename Alloc, typename Sharing>
+  int Add(const Deque<T, Alloc, Sharing>& deque) {
+    const int front = Add(deque.front_);
+    Add(deque.back_);
+    return front;
+  }
+
+  [[nodiscard]] int RootCount() const {
+    return static_cast<int>(roots_.size());
+  }
+
+  [[nodiscard]] std::uint64_t NodeCount() const { return nodes_.size(); }
+
+  // Throws std::runtime_error if the stream fails.
+  void Write(std::ostream& out) const {
+    SnapshotHeader header{};
+    header.magic_ = kSnapshotMagic;
+    header.version_ = kSnapshotVersion;
+    header.byte_order_ = kSnapshotByteOrder;
+    header.value_size_ = sizeof(T);
+    header.value_align_ = alignof(T);
+    header.node_count_ = nodes_.size();
+    header.root_count_ = roots_.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(roots_.data()),
+              static_cast<std::streamsize>(roots_.size() *
+                                           sizeof(std::uint64_t)));
+    const std::size_t padding =
+        SnapshotNodesOffset<T>(roots_.size()) - sizeof(header) -
+        roots_.size() * sizeof(std::uint64_t);
+    constexpr std::array<char, alignof(Record)> kZeros{};
+    out.write(kZeros.data(), static_cast<std::streamsize>(padding));
+    out.write(reinterpret_cast<const char*>(nodes_.data()),
+              static_cast<std::streamsize>(nodes_.size() * sizeof(Record)));
+    if (!out) throw std::runtime_error("Failed to write snapshot");
+  }
+
+  void WriteFile(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open " + path);
+    Write(out);
+  }
+};
+
+// Read-only list stored in a snapshot, read in place. It is a pair of a
+// record array and an index, so copying it and taking its Tail() are O(1)
+// and allocate nothing. The snapshot's bytes must outlive it.
+template <FlatValue T>
+class SnapshotList {
+  using Record = SnapshotNode<T>;
+
+  const Record* nodes_ = nullptr;
+  std::uint64_t index_ = kNoSnapshotNode;
+
+  template <FlatValue>
+  friend class Snapshot;
+
+  SnapshotList(const Record* nodes, const std::uint64_t index)
+      : nodes_(nodes), index_(index) {}
+
+ public:
+  SnapshotList() = default;
+
+  [[nodiscard]] bool IsEmpty() const { return index_ == kNoSnapshotNode; }
+
+  [[nodiscard]] int Length() const {
+    return IsEmpty() ? 0 : nodes_[index_].length_;
+  }
+
+  // Throws std::runtime_error if the list is empty.
+  [[nodiscard]] const T& Head() const {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call head on an empty list");
+    return nodes_[index_].value_;
+  }
+
+  // Throws std::runtime_error if the list is empty.
+  [[nodiscard]] SnapshotList Tail() const {
+    if (IsEmpty())
+      throw std::runtime_error("Cannot call tail on an empty list");
+    return SnapshotList(nodes_, nodes_[index_].next_);
+  }
+
+  // Throws std::out_of_range if index is invalid.
+  [[nodiscard]] const T& Index(const int index) const {
+    if (index < 0 || index >= Length())
+      throw std::out_of_range("Index out of range");
+    std::uint64_t cur = index_;
+    for (int i = 0; i < index; i++) cur = nodes_[cur].next_;
+    return nodes_[cur].value_;
+  }
+
+  // Copy into an ordinary list.
+  template <typename List = LinkedList<T>>
+  [[nodiscard]] List ToList() const {
+    typename List::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  class const_iterator {
+    const Record* nodes_ = nullptr;
+    std::uint64_t index_ = kNoSnapshotNode;
+
+    const_iterator(const Record* nodes, const std::uint64_t index)
+        : nodes_(nodes), index_(index) {}
+    friend class SnapshotList;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return nodes_[index_].value_; }
+    pointer operator->() const { return &nodes_[index_].value_; }
+
+    const_iterator& operator++() {
+      index_ = nodes_[index_].next_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    // Only the index matters: the end iterator has no record array.
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_;
+    }
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator(nodes_, index_);
+  }
+  [[nodiscard]] const_iterator end() const { return const_iterator(); }
+};
+
+// A snapshot in memory, typically MappedFile::Bytes(). Construction checks
+// the header and that the tables fit in bytes, in O(roots). Records are not
+// checked until they are loaded; call Validate() first to read an untrusted
+// file through views. Throws std::runtime_error on malformed input and
+// std::invalid_argument if bytes is not suitably aligned.
+template <FlatValue T>
+class Snapshot {
+  using Record = SnapshotNode<T>;
+
+  const Record* nodes_ = nullptr;
+  std::uint64_t node_count_ = 0;
+  std::vector<std::uint64_t> roots_;
+
+  void CheckRecord(const std::uint64_t index) const {
+    const Record& record = nodes_[index];
+    const bool valid =
+        record.next_ == kNoSnapshotNode
+            ? record.length_ == 1
+            : record.next_ < index &&
+                  record.length_ == nodes_[record.next_].length_ + 1;
+    if (!valid) throw std::runtime_error("Corrupt snapshot node");
+  }
+
+ public:
+  explicit Snapshot(const std::span<const std::byte> bytes) {
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(Record) != 0)
+      throw std::invalid_argument("Snapshot bytes are misaligned");
+    SnapshotHeader header;
+    if (bytes.size() < sizeof(header))
+      throw std::runtime_error("Snapshot is truncated");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic_ != kSnapshotMagic)
+      throw std::runtime_error("Not a snapshot");
+    if (header.version_ != kSnapshotVersion ||
+        header.byte_order_ != kSnapshotByteOrder)
+      throw std::runtime_error("Unsupported snapshot version or byte order");
+    if (header.value_size_ != sizeof(T) || header.value_align_ != alignof(T))
+      throw std::runtime_error("Snapshot holds a different element type");
+    const std::uint64_t max_roots =
+        (bytes.size() - sizeof(header)) / sizeof(std::uint64_t);
+    if (header.root_count_ > max_roots)
+      throw std::runtime_error("Snapshot is truncated");
+    const std::size_t offset = SnapshotNodesOffset<T>(header.root_count_);
+    if (offset > bytes.size() ||
+        header.node_count_ > (bytes.size() - offset) / sizeof(Record))
+      throw std::runtime_error("Snapshot is truncated");
+
+    node_count_ = header.node_count_;
+    nodes_ = reinterpret_cast<const Record*>(bytes.data() + offset);
+    roots_.resize(header.root_count_);
+    std::memcpy(roots_.data(), bytes.data() + sizeof(header),
+                roots_.size() * sizeof(std::uint64_t));
+    for (const std::uint64_t root : roots_)
+      if (root != kNoSnapshotNode && root >= node_count_)
+        throw std::runtime_error("Corrupt snapshot root");
+  }
+
+  [[nodiscard]] int RootCount() const {
+    return static_cast<int>(roots_.size());
+  }
+
+  [[nodiscard]] std::uint64_t NodeCount() const { return node_count_; }
+
+  // Check every record, in O(nodes), so that views can be trusted.
+  void Validate() const {
+    for (std::uint64_t i = 0; i < node_count_; i++) CheckRecord(i);
+  }
+
+  // In-place view of a root. O(1). Throws std::out_of_range for a bad root.
+  [[nodiscard]] SnapshotList<T> View(const int root) const {
+    if (root < 0 || root >= RootCount())
+      throw std::out_of_range("Root out of range");
+    return SnapshotList<T>(nodes_, roots_[root]);
+  }
+
+  // Rebuild every root as an ordinary list, in one pass over the records.
+  // Nodes shared in the snapshot are shared in the result.
+  template <typename List = LinkedList<T>>
+  [[nodiscard]] std::vector<List> Load() const {
+    std::unordered_map<std::uint64_t, List> shared;
+    List previous;
+    for (std::uint64_t i = 0; i < node_count_; i++) {
+      CheckRecord(i);
+      const Record& record = nodes_[i];
+      List next;
+      if (record.next_ == kNoSnapshotNode) {
+        // Last node of a list.
+      } else if (record.next_ + 1 == i) {
+        next = std::move(previous);
+      } else {
+        const auto found = shared.find(record.next_);
+        if (found == shared.end())
+          throw std::runtime_error("Corrupt snapshot node");
+        next = found->second;
+      }
+      previous = List(record.value_, std::move(next));
+      if ((record.flags_ & kSnapshotNodeShared) != 0)
+        shared.emplace(i, previous);
+    }
+    std::vector<List> lists;
+    lists.reserve(roots_.size());
+    for (const std::uint64_t root : roots_) {
+      if (root == kNoSnapshotNode) {
+        lists.emplace_back();
+        continue;
+      }
+      const auto found = shared.find(root);
+      if (found == shared.end())
+        throw std::runtime_error("Corrupt snapshot root");
+      lists.push_back(found->second);
+    }
+    return lists;
+  }
+
+  // Rebuild the deque written by SnapshotWriter::Add(deque) that returned
+  // front_root. Loads every root, so snapshots holding many structures are
+  // better loaded with Load() once.
+  template <typename D = Deque<T>>
+  [[nodiscard]] D LoadDeque(const int front_root) const {
+    if (front_root < 0 || front_root + 1 >= RootCount())
+      throw std::out_of_range("Root out of range");
+    auto lists = Load<typename D::List>();
+    return D(std::move(lists[front_root]), std::move(lists[front_root + 1]));
+  }
+};
+
+#endif  // SERIALIZATION_SNAPSHOT_H
@@ -0,0 +1,326 @@
+#ifndef SHARING_SHARING_H
+#define SHARING_SHARING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/single_threaded.h>)
+#include <sys/single_threaded.h>
+#endif
+
+// Sharing policies decide how persistent structures reference-count their
+// nodes. A policy provides:
+// - Ptr<U, Alloc>: the owning pointer type stored in the structure. It
+//   supports get(), ->, *, use_count(), comparison with nullptr, copying
+//   and moving.
+// - Make<U, Alloc>(args...): allocate and construct a U with Alloc.
+// - kBlockBytes<U, Alloc>: the size of the allocation Make makes for a U,
+//   reference count included, as reported by memory/MemoryStats.h.
+// - NodeHeader: a base class for node types. A node deriving from it holds
+//   its own reference count, so its first fields can pack into the same
+//   word as the count instead of starting after it (see LinkedList::Node).
+//   Nodes that do not derive from it still work.
+// - Immortal<U, Alloc>(object): a Ptr to an object in static storage that
+//   is never freed, as StaticList's nodes are. The object must have been
+//   built with the NodeHeader(kImmortal) constructor. For the intrusive
+//   policies this is constexpr, so such objects can be constant-initialized.
+//
+// AtomicSharing (the default) uses std::shared_ptr, so versions may be
+// shared freely between threads. IntrusiveSharing is thread-safe too, but
+// keeps a 32-bit atomic count in the node's own allocation and points to it
+// with a single pointer. That makes LinkedList<int> nodes 24 bytes instead
+// of 40 and the list handle 8 bytes instead of 16. Unlike shared_ptr it
+// supports no weak references or aliasing.
+// LocalSharing is the same layout with a non-atomic count. It avoids the
+// locked instructions on every copy, but a structure using it, and every
+// version that shares nodes with it, must stay on one thread. To move data
+// across threads, convert it with WithSharing<AtomicSharing>() first.
+// Intrusive counts are 32 bits wide: a node may have at most 2^32 - 1
+// owners at a time.
+
+// True while the process has only ever had one thread, as glibc reports
+// and libstdc++'s shared_ptr checks: counts can then be updated without
+// locked instructions. The flag is cleared before a second thread starts.
+inline bool IsSingleThreaded() {
+#if __has_include(<sys/single_threaded.h>)
+  return __libc_single_threaded != 0;
+#else
+  return false;
+#endif
+}
+
+// Tag for the constructors of objects whose references are never counted
+// down to zero (see Immortal above).
+struct ImmortalTag {
+  explicit ImmortalTag() = default;
+};
+inline constexpr ImmortalTag kImmortal{};
+
+// Intrusive reference count, atomic or not. Copying a node must not copy its
+// count, so copies start at one owner and assignment leaves the count alone.
+template <bool kAtomic>
+class RefCountHeader {
+  template <typename, typename, bool>
+  friend class IntrusivePtr;
+
+  // Immortal objects start halfway up the range, so the references that
+  // come and go at run time never bring them down to zero.
+  static constexpr std::uint32_t kImmortalRefs = std::uint32_t{1} << 31;
+
+  std::conditional_t<kAtomic, std::atomic<std::uint32_t>, std::uint32_t>
+      refs_ = 1;
+
+  void Acquire() {
+    if constexpr (kAtomic) {
+      if (IsSingleThreaded()) {
+        refs_.store(refs_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+      } else {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else {
+      refs_++;
+    }
+  }
+
+  // True if the caller dropped the last reference.
+  bool Release() {
+    if constexpr (kAtomic) {
+      if (IsSingleThreaded()) {
+        const std::uint32_t refs = refs_.load(std::memory_order_relaxed) - 1;
+        refs_.store(refs, std::memory_order_relaxed);
+        return refs == 0;
+      }
+      return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    } else {
+      return --refs_ == 0;
+    }
+  }
+
+  [[nodiscard]] std::uint32_t Count() const {
+    if constexpr (kAtomic) {
+      return refs_.load(std::memory_order_acquire);
+    } else {
+      return refs_;
+    }
+  }
+
+ public:
+  RefCountHeader() = default;
+  constexpr explicit RefCountHeader(ImmortalTag /*tag*/)
+      : refs_(kImmortalRefs) {}
+  RefCountHeader(const RefCountHeader& /*other*/) {}
+  RefCountHeader& operator=(const RefCountHeader& /*other*/) { return *this; }
+};
+
+// Owning pointer to a U that lives in the same block as its 32-bit
+// reference count. If U derives from RefCountHeader<kAtomic> the count is
+// the one U embeds; otherwise it is wrapped in a Block with U.
+// U may still be incomplete where the pointer is declared, as a node
+// holding the list that points to it is, so the choice is made only inside
+// member functions.
+template <typename U, typename Alloc, bool kAtomic>
+class IntrusivePtr {
+  using Header = RefCountHeader<kAtomic>;
+
+  struct Block {
+    Header header_;
+    U value_;
+
+    template <typename... Args>
+    explicit Block(Args&&... args) : value_(std::forward<Args>(args)...) {}
+  };
+
+  template <typename V = U>
+  static constexpr bool kEmbedded = std::is_base_of_v<Header, V>;
+  template <typename V = U>
+  using Stored = std::conditional_t<kEmbedded<V>, V, Block>;
+  template <typename V = U>
+  using StoredAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Stored<V>>;
+  template <typename V = U>
+  using StoredTraits = std::allocator_traits<StoredAlloc<V>>;
+
+  // A Stored<>*, or null.
+  void* block_;
+
+  constexpr explicit IntrusivePtr(void* block) : block_(block) {}
+
+  template <typename V = U>
+  [[nodiscard]] Stored<V>* Storage() const {
+    return static_cast<Stored<V>*>(block_);
+  }
+
+  Header& Count() const {
+    if constexpr (kEmbedded<>) {
+      return *Storage();
+    } else {
+      return Storage()->header_;
+    }
+  }
+
+  constexpr void Release() {
+    if (block_ == nullptr || !Count().Release()) return;
+    StoredAlloc<> alloc;
+    StoredTraits<>::destroy(alloc, Storage());
+    StoredTraits<>::deallocate(alloc, Storage(), 1);
+  }
+
+ public:
+  // Size of the allocation behind each pointer.
+  static constexpr std::size_t BlockBytes() { return sizeof(Stored<>); }
+
+  constexpr IntrusivePtr() : block_(nullptr) {}
+  constexpr IntrusivePtr(std::nullptr_t) : block_(nullptr) {}  // NOLINT
+
+  IntrusivePtr(const IntrusivePtr& other) : block_(other.block_) {
+    if (block_ != nullptr) Count().Acquire();
+  }
+  IntrusivePtr(IntrusivePtr&& other) noexcept
+      : block_(std::exchange(other.block_, nullptr)) {}
+
+  IntrusivePtr& operator=(const IntrusivePtr& other) {
+    IntrusivePtr(other).Swap(*this);
+    return *this;
+  }
+  IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+    IntrusivePtr(std::move(other)).Swap(*this);
+    return *this;
+  }
+
+  constexpr ~IntrusivePtr() { Release(); }
+
+  template <typename... Args>
+  static IntrusivePtr Make(Args&&... args) {
+    StoredAlloc<> alloc;
+    Stored<>* block = StoredTraits<>::allocate(alloc, 1);
+    try {
+      StoredTraits<>::construct(alloc, block, std::forward<Args>(args)...);
+    } catch (...) {
+      StoredTraits<>::deallocate(alloc, block, 1);
+      throw;
+    }
+    return IntrusivePtr(block);
+  }
+
+  // Adopt one of the references an immortal object was created with.
+  static constexpr IntrusivePtr Immortal(U* object) {
+    static_assert(kEmbedded<>, "Immortal objects must embed their count");
+    return IntrusivePtr(object);
+  }
+
+  void Swap(IntrusivePtr& other) noexcept { std::swap(block_, other.block_); }
+
+  [[nodiscard]] U* get() const {
+    if constexpr (kEmbedded<>) {
+      return Storage();
+    } else {
+      return block_ == nullptr ? nullptr : &Storage()->value_;
+    }
+  }
+  U* operator->() const { return get(); }
+  U& operator*() const { return *get(); }
+
+  [[nodiscard]] long use_count() const {  // NOLINT(google-runtime-int)
+    return block_ == nullptr ? 0 : Count().Count();
+  }
+
+  explicit operator bool() const { return block_ != nullptr; }
+  friend bool operator==(const IntrusivePtr& ptr, std::nullptr_t) {
+    return ptr.block_ == nullptr;
+  }
+  friend bool operator==(const IntrusivePtr& lhs, const IntrusivePtr& rhs) {
+    return lhs.block_ == rhs.block_;
+  }
+};
+
+template <typename U, typename Alloc>
+using LocalPtr = IntrusivePtr<U, Alloc, false>;
+
+// Thread-safe reference counting through std::shared_ptr.
+struct AtomicSharing {
+  template <typename U, typename Alloc>
+  using Ptr = std::shared_ptr<U>;
+
+  // shared_ptr keeps its counts in its own control block.
+  struct NodeHeader {
+    NodeHeader() = default;
+    constexpr explicit NodeHeader(ImmortalTag /*tag*/) {}
+  };
+
+  // std::allocate_shared puts U after a control block holding a vtable
+  // pointer and the use and weak counts: two ints in libstdc++, two longs in
+  // libc++.
+  template <typename U>
+  struct ControlBlockLayout {
+    void* vtable_;
+#ifdef _LIBCPP_VERSION
+    long uses_, weak_;  // NOLINT(google-runtime-int)
+#else
+    int uses_, weak_;
+#endif
+    U value_;
+  };
+  template <typename U, typename Alloc>
+  static constexpr std::size_t kBlockBytes = sizeof(ControlBlockLayout<U>);
+
+  template <typename U, typename Alloc, typename... Args>
+  static Ptr<U, Alloc> Make(Args&&... args) {
+    return std::allocate_shared<U>(Alloc(), std::forward<Args>(args)...);
+  }
+
+  // Points to object without owning anything, so copies of it update no
+  // counts at all.
+  template <typename U, typename Alloc>
+  static Ptr<U, Alloc> Immortal(U* object) {
+    return Ptr<U, Alloc>(std::shared_ptr<void>(), object);
+  }
+};
+
+// Thread-safe, intrusive reference counting with a 32-bit atomic count.
+struct IntrusiveSharing {
+  template <typename U, typename Alloc>
+  using Ptr = IntrusivePtr<U, Alloc, true>;
+
+  using NodeHeader = RefCountHeader<true>;
+
+  template <typename U, typename Alloc>
+  static constexpr std::size_t kBlockBytes = Ptr<U, Alloc>::BlockBytes();
+
+  template <typename U, typename Alloc, typename... Args>
+  static Ptr<U, Alloc> Make(Args&&... args) {
+    return Ptr<U, Alloc>::Make(std::forward<Args>(args)...);
+  }
+
+  template <typename U, typename Alloc>
+  static constexpr Ptr<U, Alloc> Immortal(U* object) {
+    return Ptr<U, Alloc>::Immortal(object);
+  }
+};
+
+// Single-threaded, intrusive, non-atomic reference counting.
+struct LocalSharing {
+  template <typename U, typename Alloc>
+  using Ptr = LocalPtr<U, Alloc>;
+
+  using NodeHeader = RefCountHeader<false>;
+
+  template <typename U, typename Alloc>
+  static constexpr std::size_t kBlockBytes = Ptr<U, Alloc>::BlockBytes();
+
+  template <typename U, typename Alloc, typename... Args>
+  static Ptr<U, Alloc> Make(Args&&... args) {
+    return Ptr<U, Alloc>::Make(std::forward<Args>(args)...);
+  }
+
+  template <typename U, typename Alloc>
+  static constexpr Ptr<U, Alloc> Immortal(U* object) {
+    return Ptr<U, Alloc>::Immortal(object);
+  }
+};
+
+#endif  // SHARING_SHARING_H
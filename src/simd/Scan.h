@@ -0,0 +1,227 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if __has_include(<experimental/simd>) && !defined(IMMUTABLE_NO_SIMD)
+#include <experimental/simd>
+#define IMMUTABLE_HAVE_SIMD 1
+#endif
+
+// Vectorised Find, Contains, Count, Sum, Min and Max over structures that
+// store their elements contiguously per node: ChunkedList and
+// PersistentVector, which expose their nodes through ForEachChunk.
+// Design notes:
+// - Each node's elements are scanned as a whole with the kernels below,
+//   std::experimental::simd::native_simd<T> lanes at a time plus a scalar
+//   remainder, so a scan costs one pointer chase per node rather than per
+//   element.
+// - The vector path is chosen at compile time for arithmetic T (other than
+//   bool) when <experimental/simd> is available. Other element types, and
+//   builds defining IMMUTABLE_NO_SIMD, use the scalar loops. Lane width
+//   follows the target flags, e.g. -march=native enables AVX2 where present.
+// - Sum and the floating-point reductions combine lanes in a different order
+//   from a left fold, so float sums may differ in the last bits. Min and Max
+//   of data containing NaN are unspecified.
+// - Min and Max throw std::runtime_error on an empty structure, as Head does
+//   on an empty list.
+
+template <typename T>
+inline constexpr bool kSimdScannable =
+#ifdef IMMUTABLE_HAVE_SIMD
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+#else
+    false;
+#endif
+
+#ifdef IMMUTABLE_HAVE_SIMD
+template <typename T>
+using SimdVector = std::experimental::native_simd<T>;
+#endif
+
+// Index of the first element equal to value, or -1.
+template <typename T>
+std::ptrdiff_t SimdFind(const std::span<const T> elements, const T& value) {
+  std::size_t i = 0;
+#ifdef IMMUTABLE_HAVE_SIMD
+  if constexpr (kSimdScannable<T>) {
+    constexpr std::size_t kLanes = SimdVector<T>::size();
+    for (; i + kLanes <= elements.size(); i += kLanes) {
+      const SimdVector<T> lanes(elements.data() + i,
+                                std::experimental::element_aligned);
+      const auto matches = lanes == value;
+      if (std::experimental::any_of(matches))
+        return static_cast<std::ptrdiff_t>(
+            i + std::experimental::find_first_set(matches));
+    }
+  }
+#endif
+  for (; i < elements.size(); i++)
+    if (elements[i] == value) return static_cast<std::ptrdiff_t>(i);
+  return -1;
+}
+
+// Number of elements equal to value.
+template <typename T>
+std::size_t SimdCount(const std::span<const T> elements, const T& value) {
+  std::size_t count = 0;
+  std::size_t i = 0;
+#ifdef IMMUTABLE_HAVE_SIMD
+  if constexpr (kSimdScannable<T>) {
+    constexpr std::size_t kLanes = SimdVector<T>::size();
+    for (; i + kLanes <= elements.size(); i += kLanes) {
+      const SimdVector<T> lanes(elements.data() + i,
+                                std::experimental::element_aligned);
+      count += std::experimental::popcount(lanes == value);
+    }
+  }
+#endif
+  for (; i < elements.size(); i++)
+    if (elements[i] == value) count++;
+  return count;
+}
+
+template <typename T>
+T SimdSum(const std::span<const T> elements) {
+  T sum{};
+  std::size_t i = 0;
+#ifdef IMMUTABLE_HAVE_SIMD
+  if constexpr (kSimdScannable<T>) {
+    constexpr std::size_t kLanes = SimdVector<T>::size();
+    if (elements.size() >= kLanes) {
+      SimdVector<T> lanes_sum(T{});
+      for (; i + kLanes <= elements.size(); i += kLanes)
+        lanes_sum += SimdVector<T>(elements.data() + i,
+                                   std::experimental::element_aligned);
+      sum = std::experimental::reduce(lanes_sum);
+    }
+  }
+#endif
+  for (; i < elements.size(); i++) sum += elements[i];
+  return sum;
+}
+
+// Smallest (Less = std::less) or largest (std::greater) element of a
+// non-empty span.
+template <typename T, typename Less>
+T SimdExtreme(const std::span<const T> elements, Less less) {
+  T best = elements[0];
+  std::size_t i = 0;
+#ifdef IMMUTABLE_HAVE_SIMD
+  if constexpr (kSimdScannable<T>) {
+    constexpr std::size_t kLanes = SimdVector<T>::size();
+    if (elements.size() >= kLanes) {
+      SimdVector<T> lanes_best(elements.data(),
+                               std::experimental::element_aligned);
+      for (i = kLanes; i + kLanes <= elements.size(); i += kLanes) {
+        const SimdVector<T> lanes(elements.data() + i,
+                                  std::experimental::element_aligned);
+        if constexpr (std::is_same_v<Less, std::less<>>) {
+          lanes_best = std::experimental::min(lanes_best, lanes);
+        } else {
+          lanes_best = std::experimental::max(lanes_best, lanes);
+        }
+      }
+      best = std::is_same_v<Less, std::less<>>
+                 ? std::experimental::hmin(lanes_best)
+                 : std::experimental::hmax(lanes_best);
+    }
+  }
+#endif
+  for (; i < elements.size(); i++)
+    if (less(elements[i], best)) best = elements[i];
+  return best;
+}
+
+template <typename C>
+using ChunkValue = std::ranges::range_value_t<C>;
+
+template <typename C>
+concept ChunkScannable =
+    std::ranges::forward_range<C> &&
+    requires(const C& c, bool (*fn)(std::span<const ChunkValue<C>>)) {
+      c.ForEachChunk(fn);
+    };
+
+// Index of the first element equal to value, or -1.
+template <ChunkScannable C>
+int Find(const C& container, const ChunkValue<C>& value) {
+  using T = ChunkValue<C>;
+  int index = -1;
+  int before = 0;
+  container.ForEachChunk([&](const std::span<const T> chunk) {
+    const std::ptrdiff_t found = SimdFind(chunk, value);
+    if (found < 0) {
+      before += static_cast<int>(chunk.size());
+      return true;
+    }
+    index = before + static_cast<int>(found);
+    return false;
+  });
+  return index;
+}
+
+template <ChunkScannable C>
+bool Contains(const C& container, const ChunkValue<C>& value) {
+  return Find(container, value) >= 0;
+}
+
+// Number of elements equal to value.
+template <ChunkScannable C>
+int Count(const C& container, const ChunkValue<C>& value) {
+  using T = ChunkValue<C>;
+  std::size_t count = 0;
+  container.ForEachChunk([&](const std::span<const T> chunk) {
+    count += SimdCount(chunk, value);
+    return true;
+  });
+  return static_cast<int>(count);
+}
+
+// Sum of the elements, T{} when there are none.
+template <ChunkScannable C>
+ChunkValue<C> Sum(const C& container) {
+  using T = ChunkValue<C>;
+  T sum{};
+  container.ForEachChunk([&](const std::span<const T> chunk) {
+    sum += SimdSum(chunk);
+    return true;
+  });
+  return sum;
+}
+
+template <typename T, typename C, typename Less>
+T ChunkExtreme(const C& container, Less less, const char* message) {
+  std::optional<T> best;
+  container.ForEachChunk([&](const std::span<const T> chunk) {
+    if (chunk.empty()) return true;
+    const T chunk_best = SimdExtreme(chunk, less);
+    if (!best.has_value() || less(chunk_best, *best)) best = chunk_best;
+    return true;
+  });
+  if (!best.has_value()) throw std::runtime_error(message);
+  return *best;
+}
+
+// Throws std::runtime_error if container is empty.
+template <ChunkScannable C>
+ChunkValue<C> Min(const C& container) {
+  return ChunkExtreme<ChunkValue<C>>(container, std::less<>(),
+                                     "Cannot call min on an empty list");
+}
+
+// Throws std::runtime_error if container is empty.
+template <ChunkScannable C>
+ChunkValue<C> Max(const C& container) {
+  return ChunkExtreme<ChunkValue<C>>(container, std::greater<>(),
+                                     "Cannot call max on an empty list");
+}
+
+#endif  // SIMD_SCAN_H
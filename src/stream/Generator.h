@@ -0,0 +1,126 @@
+#ifndef STREAM_GENERATOR_H
+#define STREAM_GENERATOR_H
+
+#include <version>
+
+#ifdef __cpp_lib_generator
+#include <generator>
+#else
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+#endif
+
+// Generator<T> is std::generator<T> where the standard library provides it,
+// so that producers are written as coroutines:
+//
+//   Generator<Record> Records(Socket& socket) {
+//     while (auto record = socket.Read()) co_yield *record;
+//   }
+//
+// Otherwise it is a minimal stand-in with the same use: a move-only input
+// range whose iterator resumes the coroutine to produce each element.
+// Elements are read as const T&, valid until the iterator is next
+// incremented, and an exception escaping the coroutine is rethrown from
+// begin() or ++.
+#ifdef __cpp_lib_generator
+
+template <typename T>
+using Generator = std::generator<T>;
+
+#else
+
+template <typename T>
+class Generator : public std::ranges::view_interface<Generator<T>> {
+ public:
+  struct promise_type {
+    const T* current_ = nullptr;
+    std::exception_ptr exception_;
+
+    Generator get_return_object() {
+      return Generator(Handle::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    // A yielded temporary lives until the coroutine resumes, so pointing to
+    // it is safe.
+    std::suspend_always yield_value(const T& value) noexcept {
+      current_ = std::addressof(value);
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() { exception_ = std::current_exception(); }
+    // Generators produce values; they do not await anything.
+    template <typename U>
+    std::suspend_never await_transform(U&& value) = delete;
+  };
+
+ private:
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Handle handle_;
+
+  explicit Generator(const Handle handle) : handle_(handle) {}
+
+  // Resume until the next co_yield or the end, rethrowing what escaped.
+  static void Advance(const Handle handle) {
+    handle.resume();
+    if (handle.done() && handle.promise().exception_ != nullptr)
+      std::rethrow_exception(std::exchange(handle.promise().exception_, {}));
+  }
+
+ public:
+  class iterator {
+    Handle handle_;
+
+    explicit iterator(const Handle handle) : handle_(handle) {}
+    friend class Generator;
+
+   public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    iterator(iterator&&) = default;
+    iterator& operator=(iterator&&) = default;
+
+    const T& operator*() const { return *handle_.promise().current_; }
+
+    iterator& operator++() {
+      Advance(handle_);
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) {
+      return it.handle_.done();
+    }
+  };
+
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+  Generator(Generator&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  Generator& operator=(Generator&& other) noexcept {
+    std::swap(handle_, other.handle_);
+    return *this;
+  }
+  ~Generator() {
+    if (handle_) handle_.destroy();
+  }
+
+  // Starts the coroutine; call once.
+  iterator begin() {
+    Advance(handle_);
+    return iterator(handle_);
+  }
+  std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+#endif  // __cpp_lib_generator
+
+#endif  // STREAM_GENERATOR_H
@@ -0,0 +1,120 @@
+#ifndef STREAM_STREAM_PUBLISHER_H
+#define STREAM_STREAM_PUBLISHER_H
+
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <utility>
+
+#include "atomicref/AtomicRef.h"
+
+// Builds a persistent Deque from a stream of elements and publishes growing
+// snapshots of it through an AtomicRef, so that readers see consistent
+// versions while an ingest thread keeps appending.
+// Design notes:
+// - Elements go through Deque::Builder, which pushes onto the head of a list
+//   in O(1) without any rebalancing. A snapshot is Builder::Snapshot(),
+//   O(1) as well, and shares every node with the builder, so publishing
+//   costs one boxed version per snapshot whatever the deque's length.
+// - A snapshot is published once every_elements_ elements have arrived
+//   since the last one, or once every_ has passed since it, whichever comes
+//   first. Time is checked when an element arrives, so a source that goes
+//   quiet leaves its last few elements unpublished until the next element,
+//   Flush() or Finish().
+// - Reading the clock costs about as much as a push, so while elements
+//   arrive much faster than every_ the clock is read only every few (at
+//   most kMaxClockStride) pushes. When they slow down it is read on every
+//   push again.
+// - Publishing starts from the deque the reference holds when the publisher
+//   is created, and Store()s over it: one publisher should own the reference
+//   while it runs. Readers need no locks, and never delay the publisher.
+// - Push takes elements from any source: callbacks of an asynchronous
+//   reader, a queue, or a coroutine (see Generator.h) drained by
+//   PublishStream.
+// - Deque versions are handed between threads, so D must not use
+//   LocalSharing.
+
+// When StreamPublisher publishes a snapshot.
+struct PublishPolicy {
+  int every_elements_ = 1024;
+  std::chrono::steady_clock::duration every_ = std::chrono::milliseconds(10);
+};
+
+template <typename D>
+class StreamPublisher {
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int kMaxClockStride = 64;
+
+  AtomicRef<D>& target_;
+  PublishPolicy policy_;
+  typename D::Builder builder_;
+  int pending_ = 0;
+  Clock::time_point last_publish_;
+  // Pushes between clock reads, and pushes left until the next one.
+  int clock_stride_ = 1;
+  int until_clock_ = 1;
+  Clock::time_point last_clock_;
+
+ public:
+  explicit StreamPublisher(AtomicRef<D>& target,
+                           const PublishPolicy policy = {})
+      : target_(target),
+        policy_(policy),
+        builder_(target.Load()),
+        last_publish_(Clock::now()),
+        last_clock_(last_publish_) {}
+
+  StreamPublisher(const StreamPublisher&) = delete;
+  StreamPublisher& operator=(const StreamPublisher&) = delete;
+
+  // Elements pushed since the last snapshot was published.
+  [[nodiscard]] int Pending() const { return pending_; }
+
+  template <typename U>
+  void Push(U&& element) {
+    builder_.Snoc(std::forward<U>(element));
+    pending_++;
+    if (pending_ >= policy_.every_elements_) {
+      Flush();
+      return;
+    }
+    if (--until_clock_ > 0) return;
+    const Clock::time_point now = Clock::now();
+    // Less than an eighth of the interval since the last read: the next
+    // read can wait for twice as many pushes.
+    clock_stride_ = now - last_clock_ < policy_.every_ / 8
+                        ? std::min(clock_stride_ * 2, kMaxClockStride)
+                        : 1;
+    until_clock_ = clock_stride_;
+    last_clock_ = now;
+    if (now - last_publish_ >= policy_.every_) Flush();
+  }
+
+  // Publish the elements pushed so far, if there are any new ones.
+  void Flush() {
+    if (pending_ == 0) return;
+    target_.Store(builder_.Snapshot());
+    pending_ = 0;
+    last_publish_ = Clock::now();
+  }
+
+  // Publish everything and return the final version.
+  D Finish() {
+    Flush();
+    return builder_.Snapshot();
+  }
+};
+
+// Drain source, typically a Generator, into target through a
+// StreamPublisher. Returns the final version, which is also published.
+template <typename D, std::ranges::input_range R>
+D PublishStream(AtomicRef<D>& target, R&& source,
+                const PublishPolicy policy = {}) {
+  StreamPublisher<D> publisher(target, policy);
+  for (auto&& element : source)
+    publisher.Push(std::forward<decltype(element)>(element));
+  return publisher.Finish();
+}
+
+#endif  // STREAM_STREAM_PUBLISHER_H
@@ -0,0 +1,658 @@
+#ifndef VECTOR_PERSISTENT_VECTOR_H
+#define VECTOR_PERSISTENT_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+// Immutable vector with structural sharing, implemented as a relaxed radix
+// balanced tree (RRB-tree, Bagwell & Rompf) with a tail buffer.
+// Representation:
+// - Elements live in leaves of up to kWidth (32) elements. Internal nodes
+//   (branches) hold up to kWidth children together with a table of
+//   cumulative subtree sizes, so leaves need not be full.
+// - The last few elements live in a separate tail leaf outside the tree, so
+//   Snoc usually only copies the tail.
+// - A tree of height h has its leaves h levels below the root; a root of
+//   height 0 is a single leaf.
+// Complexity:
+// - Index, Update and Snoc are O(log32 n), which is effectively constant.
+// - Append (concatenation), Take, Drop and Slice are O(log n). Append merges
+//   the right spine of one tree with the left spine of the other and
+//   redistributes only the nodes along that seam.
+// Design notes:
+// - Index descends using the radix of the index as a first guess and then
+//   scans forward through the size table. For trees built by Snoc the guess
+//   is always right.
+// - Methods taking an index throw std::out_of_range when it is invalid.
+template <typename T>
+class PersistentVector {
+  static constexpr int kBits = 5;
+  static constexpr int kWidth = 1 << kBits;
+  // A node may fall at most kInvariant slots short of full before Append
+  // redistributes it, and a level may use at most kExtras more nodes than
+  // the optimum.
+  static constexpr int kInvariant = 1;
+  static constexpr int kExtras = 2;
+
+  using Ptr = std::shared_ptr<const void>;
+
+  struct Leaf {
+    int count_ = 0;
+    alignas(T) std::byte storage_[kWidth * sizeof(T)];
+
+    Leaf() = default;
+    Leaf(const Leaf&) = delete;
+    Leaf& operator=(const Leaf&) = delete;
+    Leaf(Leaf&&) = delete;
+    Leaf& operator=(Leaf&&) = delete;
+    ~Leaf() { std::destroy_n(Data(), count_); }
+
+    T* Data() { return std::launder(reinterpret_cast<T*>(storage_)); }
+    const T* Data() const {
+      return std::launder(reinterpret_cast<const T*>(storage_));
+    }
+
+    template <typename... Args>
+    void Push(Args&&... args) {
+      std::construct_at(Data() + count_, std::forward<Args>(args)...);
+      count_++;
+    }
+  };
+
+  struct Branch {
+    int count_ = 0;
+    std::array<Ptr, kWidth> children_;
+    // sizes_[i] is the number of elements in children 0..i.
+    std::array<int, kWidth> sizes_;
+
+    [[nodiscard]] int Size() const {
+      return count_ == 0 ? 0 : sizes_[count_ - 1];
+    }
+
+    void Push(Ptr child, const int child_size) {
+      children_[count_] = std::move(child);
+      sizes_[count_] = Size() + child_size;
+      count_++;
+    }
+
+    // Index of the child holding position index, for a node of height.
+    [[nodiscard]] int ChildFor(const int index, const int height) const {
+      int child = index >> (height * kBits);
+      while (sizes_[child] <= index) child++;
+      return child;
+    }
+
+    [[nodiscard]] int Before(const int child) const {
+      return child == 0 ? 0 : sizes_[child - 1];
+    }
+  };
+
+  static const Leaf* AsLeaf(const void* node) {
+    return static_cast<const Leaf*>(node);
+  }
+  static const Branch* AsBranch(const void* node) {
+    return static_cast<const Branch*>(node);
+  }
+
+  // Number of elements below node.
+  static int SizeOf(const void* node, const int height) {
+    return height == 0 ? AsLeaf(node)->count_ : AsBranch(node)->Size();
+  }
+
+  // Number of occupied slots in node: elements or children.
+  static int SlotsOf(const void* node, const int height) {
+    return height == 0 ? AsLeaf(node)->count_ : AsBranch(node)->count_;
+  }
+
+  static std::shared_ptr<Branch> CopyBranch(const Branch* branch) {
+    return std::make_shared<Branch>(*branch);
+  }
+
+  // Copy count elements of leaf starting at first into a new leaf.
+  static std::shared_ptr<Leaf> CopyLeaf(const Leaf* leaf, const int first,
+                                        const int count) {
+    auto copy = std::make_shared<Leaf>();
+    for (int i = first; i < first + count; i++) copy->Push(leaf->Data()[i]);
+    return copy;
+  }
+
+  // Call fn with the elements of each leaf below node, in order. Returns
+  // false as soon as fn does.
+  template <typename Fn>
+  static bool ForEachLeaf(const void* node, const int height, Fn& fn) {
+    if (height == 0) {
+      const Leaf* leaf = AsLeaf(node);
+      return fn(std::span<const T>(leaf->Data(), leaf->count_));
+    }
+    const Branch* branch = AsBranch(node);
+    for (int i = 0; i < branch->count_; i++) {
+      if (!ForEachLeaf(branch->children_[i].get(), height - 1, fn))
+        return false;
+    }
+    return true;
+  }
+
+  int size_;
+  int height_;
+  // Null if every element is in the tail.
+  Ptr root_;
+  // Null if the tail is empty. Only Take and Drop leave it empty while the
+  // tree is not.
+  std::shared_ptr<const Leaf> tail_;
+
+  PersistentVector(const int size, const int height, Ptr root,
+                   std::shared_ptr<const Leaf> tail)
+      : size_(size),
+        height_(height),
+        root_(std::move(root)),
+        tail_(std::move(tail)) {}
+
+  [[nodiscard]] int TailSize() const {
+    return tail_ == nullptr ? 0 : tail_->count_;
+  }
+  [[nodiscard]] int TailOffset() const { return size_ - TailSize(); }
+
+  // Leaf holding index and the position of its first element.
+  [[nodiscard]] std::pair<const Leaf*, int> LeafFor(int index) const {
+    const int tail_offset = TailOffset();
+    if (index >= tail_offset) return {tail_.get(), tail_offset};
+    const int start = index;
+    const void* node = root_.get();
+    for (int height = height_; height > 0; height--) {
+      const Branch* branch = AsBranch(node);
+      const int child = branch->ChildFor(index, height);
+      index -= branch->Before(child);
+      node = branch->children_[child].get();
+    }
+    return {AsLeaf(node), start - index};
+  }
+
+  // Chain of single-child branches of the given height ending in leaf.
+  static Ptr NewPath(const int height, Ptr leaf, const int leaf_size) {
+    if (height == 0) return leaf;
+    auto branch = std::make_shared<Branch>();
+    branch->Push(NewPath(height - 1, std::move(leaf), leaf_size), leaf_size);
+    return branch;
+  }
+
+  // Add leaf as the new rightmost leaf below branch, or return null if the
+  // subtree is full.
+  static Ptr PushInto(const Branch* branch, const int height, const Ptr& leaf,
+                      const int leaf_size) {
+    if (height > 1) {
+      const int last = branch->count_ - 1;
+      Ptr pushed = PushInto(AsBranch(branch->children_[last].get()),
+                            height - 1, leaf, leaf_size);
+      if (pushed != nullptr) {
+        auto copy = CopyBranch(branch);
+        copy->children_[last] = std::move(pushed);
+        copy->sizes_[last] += leaf_size;
+        return copy;
+      }
+    }
+    if (branch->count_ == kWidth) return nullptr;
+    auto copy = CopyBranch(branch);
+    copy->Push(NewPath(height - 1, leaf, leaf_size), leaf_size);
+    return copy;
+  }
+
+  // Tree (root, height) with leaf added at its right edge.
+  static std::pair<Ptr, int> PushLeaf(const Ptr& root, const int height,
+                                      const Ptr& leaf, const int leaf_size) {
+    if (root == nullptr) return {leaf, 0};
+    if (height > 0) {
+      Ptr pushed = PushInto(AsBranch(root.get()), height, leaf, leaf_size);
+      if (pushed != nullptr) return {std::move(pushed), height};
+    }
+    auto branch = std::make_shared<Branch>();
+    branch->Push(root, SizeOf(root.get(), height));
+    branch->Push(NewPath(height, leaf, leaf_size), leaf_size);
+    return {std::move(branch), height + 1};
+  }
+
+  static Ptr UpdateNode(const void* node, const int height, const int index,
+                        const T& element) {
+    if (height == 0) {
+      const Leaf* leaf = AsLeaf(node);
+      auto copy = std::make_shared<Leaf>();
+      for (int i = 0; i < leaf->count_; i++)
+        copy->Push(i == index ? element : leaf->Data()[i]);
+      return copy;
+    }
+    const Branch* branch = AsBranch(node);
+    const int child = branch->ChildFor(index, height);
+    auto copy = CopyBranch(branch);
+    copy->children_[child] =
+        UpdateNode(branch->children_[child].get(), height - 1,
+                   index - branch->Before(child), element);
+    return copy;
+  }
+
+  // Plan how to redistribute the slots of a run of sibling nodes so that the
+  // run uses at most kExtras nodes more than the optimum. Returns the new
+  // slot count of each node.
+  static std::vector<int> ConcatPlan(std::vector<int> slots) {
+    int total = 0;
+    for (const int count : slots) total += count;
+    const int optimal = (total + kWidth - 1) / kWidth;
+    int length = static_cast<int>(slots.size());
+    int i = 0;
+    while (optimal + kExtras < length) {
+      // Find the first node that is short enough to be worth merging away
+      // and spread its slots over the nodes that follow it.
+      while (slots[i] > kWidth - kInvariant) i++;
+      int remaining = slots[i];
+      do {
+        const int merged = std::min(remaining + slots[i + 1], kWidth);
+        remaining = remaining + slots[i + 1] - merged;
+        slots[i] = merged;
+        i++;
+      } while (remaining > 0);
+      for (int j = i; j < length - 1; j++) slots[j] = slots[j + 1];
+      length--;
+      i--;
+    }
+    slots.resize(length);
+    return slots;
+  }
+
+  // Rebuild nodes (all of the given height) to match plan, reusing every node
+  // whose contents do not move.
+  static std::vector<Ptr> ExecutePlan(const std::vector<Ptr>& nodes,
+                                      const int height,
+                                      const std::vector<int>& plan) {
+    std::vector<Ptr> result;
+    result.reserve(plan.size());
+    std::size_t source = 0;
+    int offset = 0;
+    for (const int target : plan) {
+      if (offset == 0 && SlotsOf(nodes[source].get(), height) == target) {
+        result.push_back(nodes[source++]);
+        continue;
+      }
+      std::shared_ptr<Leaf> leaf;
+      std::shared_ptr<Branch> branch;
+      if (height == 0) {
+        leaf = std::make_shared<Leaf>();
+      } else {
+        branch = std::make_shared<Branch>();
+      }
+      for (int filled = 0; filled < target;) {
+        const void* node = nodes[source].get();
+        const int available = SlotsOf(node, height) - offset;
+        const int taken = std::min(target - filled, available);
+        for (int i = offset; i < offset + taken; i++) {
+          if (height == 0) {
+            leaf->Push(AsLeaf(node)->Data()[i]);
+          } else {
+            const Branch* from = AsBranch(node);
+            branch->Push(from->children_[i],
+                         from->sizes_[i] - from->Before(i));
+          }
+        }
+        filled += taken;
+        offset += taken;
+        if (offset == SlotsOf(node, height)) {
+          source++;
+          offset = 0;
+        }
+      }
+      if (height == 0) {
+        result.emplace_back(std::move(leaf));
+      } else {
+        result.emplace_back(std::move(branch));
+      }
+    }
+    return result;
+  }
+
+  // Rebalance the children of left (minus its last), center and right (minus
+  // its first), all branches of the given height, and pack them into a
+  // branch of height + 1 with one or two children.
+  static std::shared_ptr<Branch> Rebalance(const Branch* left,
+                                           const Branch* center,
+                                           const Branch* right,
+                                           const int height) {
+    std::vector<Ptr> nodes;
+    if (left != nullptr)
+      nodes.insert(nodes.end(), left->children_.begin(),
+                   left->children_.begin() + left->count_ - 1);
+    nodes.insert(nodes.end(), center->children_.begin(),
+                 center->children_.begin() + center->count_);
+    if (right != nullptr)
+      nodes.insert(nodes.end(), right->children_.begin() + 1,
+                   right->children_.begin() + right->count_);
+
+    std::vector<int> slots;
+    slots.reserve(nodes.size());
+    for (const Ptr& node : nodes)
+      slots.push_back(SlotsOf(node.get(), height - 1));
+    const std::vector<Ptr> balanced =
+        ExecutePlan(nodes, height - 1, ConcatPlan(std::move(slots)));
+
+    auto top = std::make_shared<Branch>();
+    std::shared_ptr<Branch> current;
+    for (std::size_t i = 0; i < balanced.size(); i++) {
+      if (i % kWidth == 0) {
+        if (current != nullptr) top->Push(current, current->Size());
+        current = std::make_shared<Branch>();
+      }
+      current->Push(balanced[i], SizeOf(balanced[i].get(), height - 1));
+    }
+    top->Push(current, current->Size());
+    return top;
+  }
+
+  // Concatenate trees left (of height left_height) and right, returning a
+  // branch of height max(left_height, right_height) + 1.
+  static std::shared_ptr<Branch> Merge(const Ptr& left, const int left_height,
+                                       const Ptr& right,
+                                       const int right_height) {
+    if (left_height == 0 && right_height == 0) {
+      auto top = std::make_shared<Branch>();
+      top->Push(left, AsLeaf(left.get())->count_);
+      top->Push(right, AsLeaf(right.get())->count_);
+      return top;
+    }
+    if (left_height > right_height) {
+      const Branch* l = AsBranch(left.get());
+      const auto center = Merge(l->children_[l->count_ - 1], left_height - 1,
+                                right, right_height);
+      return Rebalance(l, center.get(), nullptr, left_height);
+    }
+    if (left_height < right_height) {
+      const Branch* r = AsBranch(right.get());
+      const auto center =
+          Merge(left, left_height, r->children_[0], right_height - 1);
+      return Rebalance(nullptr, center.get(), r, right_height);
+    }
+    const Branch* l = AsBranch(left.get());
+    const Branch* r = AsBranch(right.get());
+    const auto center = Merge(l->children_[l->count_ - 1], left_height - 1,
+                              r->children_[0], right_height - 1);
+    return Rebalance(l, center.get(), r, left_height);
+  }
+
+  // Remove the first count elements below node.
+  static Ptr DropNode(const Ptr& node, const int height, const int count) {
+    if (count == 0) return node;
+    if (height == 0) {
+      const Leaf* leaf = AsLeaf(node.get());
+      return CopyLeaf(leaf, count, leaf->count_ - count);
+    }
+    const Branch* branch = AsBranch(node.get());
+    const int first = branch->ChildFor(count, height);
+    auto copy = std::make_shared<Branch>();
+    const Ptr& child = branch->children_[first];
+    copy->Push(DropNode(child, height - 1, count - branch->Before(first)),
+               branch->sizes_[first] - count);
+    for (int i = first + 1; i < branch->count_; i++)
+      copy->Push(branch->children_[i], branch->sizes_[i] - branch->Before(i));
+    return copy;
+  }
+
+  // Keep only the first count elements below node.
+  static Ptr TakeNode(const Ptr& node, const int height, const int count) {
+    if (count == SizeOf(node.get(), height)) return node;
+    if (height == 0) return CopyLeaf(AsLeaf(node.get()), 0, count);
+    const Branch* branch = AsBranch(node.get());
+    const int last = branch->ChildFor(count - 1, height);
+    auto copy = std::make_shared<Branch>();
+    for (int i = 0; i < last; i++)
+      copy->Push(branch->children_[i], branch->sizes_[i] - branch->Before(i));
+    copy->Push(TakeNode(branch->children_[last], height - 1,
+                        count - branch->Before(last)),
+               count - branch->Before(last));
+    return copy;
+  }
+
+  // Strip single-child branches off the top of a tree.
+  static std::pair<Ptr, int> Shrink(Ptr root, int height) {
+    while (height > 0 && AsBranch(root.get())->count_ == 1) {
+      root = AsBranch(root.get())->children_[0];
+      height--;
+    }
+    return {std::move(root), height};
+  }
+
+  template <typename It>
+  static PersistentVector FromIterators(It first, const It last) {
+    PersistentVector vector;
+    std::shared_ptr<Leaf> leaf;
+    for (; first != last; ++first) {
+      if (leaf == nullptr) leaf = std::make_shared<Leaf>();
+      leaf->Push(*first);
+      vector.size_++;
+      if (leaf->count_ == kWidth) {
+        std::tie(vector.root_, vector.height_) =
+            PushLeaf(vector.root_, vector.height_, leaf, kWidth);
+        leaf = nullptr;
+      }
+    }
+    vector.tail_ = std::move(leaf);
+    return vector;
+  }
+
+ public:
+  PersistentVector() : size_(0), height_(0) {}
+
+  static PersistentVector Empty() { return PersistentVector(); }
+
+  static PersistentVector Single(const T& element) {
+    return Empty().Snoc(element);
+  }
+
+  template <typename Alloc, typename Sharing>
+  static PersistentVector FromList(const LinkedList<T, Alloc, Sharing>& list) {
+    return FromIterators(list.begin(), list.end());
+  }
+
+  template <typename Alloc, typename Sharing>
+  static PersistentVector FromDeque(const Deque<T, Alloc, Sharing>& deque) {
+    const auto elements = deque.Elements();
+    return FromIterators(elements.begin(), elements.end());
+  }
+
+  template <typename Alloc = std::allocator<T>,
+            typename Sharing = AtomicSharing>
+  LinkedList<T, Alloc, Sharing> ToList() const {
+    typename LinkedList<T, Alloc, Sharing>::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  template <typename Alloc = std::allocator<T>,
+            typename Sharing = AtomicSharing>
+  Deque<T, Alloc, Sharing> ToDeque() const {
+    typename Deque<T, Alloc, Sharing>::Builder builder;
+    for (const T& element : *this) builder.Snoc(element);
+    return builder.Build();
+  }
+
+  [[nodiscard]] bool IsEmpty() const { return size_ == 0; }
+
+  [[nodiscard]] int Length() const { return size_; }
+
+  // Indexing: 0-based. Throws std::out_of_range if index invalid.
+  [[nodiscard]] const T& Index(const int index) const {
+    if (index < 0 || index >= size_)
+      throw std::out_of_range("Index out of range");
+    const auto [leaf, start] = LeafFor(index);
+    return leaf->Data()[index - start];
+  }
+
+  [[nodiscard]] const T& Head() const { return Index(0); }
+
+  [[nodiscard]] const T& Last() const { return Index(size_ - 1); }
+
+  // Copy of this vector with the element at index replaced.
+  [[nodiscard]] PersistentVector Update(const int index,
+                                        const T& element) const {
+    if (index < 0 || index >= size_)
+      throw std::out_of_range("Index out of range");
+    const int tail_offset = TailOffset();
+    if (index >= tail_offset) {
+      auto tail = std::make_shared<Leaf>();
+      for (int i = 0; i < tail_->count_; i++)
+        tail->Push(i == index - tail_offset ? element : tail_->Data()[i]);
+      return PersistentVector(size_, height_, root_, std::move(tail));
+    }
+    return PersistentVector(size_, height_,
+                            UpdateNode(root_.get(), height_, index, element),
+                            tail_);
+  }
+
+  // Append element to the end.
+  [[nodiscard]] PersistentVector Snoc(const T& element) const {
+    if (TailSize() < kWidth) {
+      auto tail = std::make_shared<Leaf>();
+      for (int i = 0; i < TailSize(); i++) tail->Push(tail_->Data()[i]);
+      tail->Push(element);
+      return PersistentVector(size_ + 1, height_, root_, std::move(tail));
+    }
+    auto [root, height] = PushLeaf(root_, height_, tail_, kWidth);
+    auto tail = std::make_shared<Leaf>();
+    tail->Push(element);
+    return PersistentVector(size_ + 1, height, std::move(root),
+                            std::move(tail));
+  }
+
+  // Concatenate: returns this ++ other in O(log n).
+  [[nodiscard]] PersistentVector Append(const PersistentVector& other) const {
+    if (IsEmpty()) return other;
+    if (other.IsEmpty()) return *this;
+    if (other.root_ == nullptr) {
+      PersistentVector result = *this;
+      for (int i = 0; i < other.TailSize(); i++)
+        result = result.Snoc(other.tail_->Data()[i]);
+      return result;
+    }
+    // Flush our tail into the tree so that the two trees can be merged.
+    auto [left, left_height] =
+        tail_ == nullptr ? std::pair(root_, height_)
+                         : PushLeaf(root_, height_, tail_, TailSize());
+    auto merged = Merge(left, left_height, other.root_, other.height_);
+    auto [root, height] =
+        Shrink(std::move(merged), std::max(left_height, other.height_) + 1);
+    return PersistentVector(size_ + other.size_, height, std::move(root),
+                            other.tail_);
+  }
+
+  // First count elements. Throws std::out_of_range unless
+  // 0 <= count <= Length().
+  [[nodiscard]] PersistentVector Take(const int count) const {
+    if (count < 0 || count > size_)
+      throw std::out_of_range("Invalid slice bounds");
+    if (count == size_) return *this;
+    if (count == 0) return Empty();
+    const int tail_offset = TailOffset();
+    if (count > tail_offset)
+      return PersistentVector(count, height_, root_,
+                              CopyLeaf(tail_.get(), 0, count - tail_offset));
+    auto [root, height] = Shrink(TakeNode(root_, height_, count), height_);
+    return PersistentVector(count, height, std::move(root), nullptr);
+  }
+
+  // All but the first count elements. Throws std::out_of_range unless
+  // 0 <= count <= Length().
+  [[nodiscard]] PersistentVector Drop(const int count) const {
+    if (count < 0 || count > size_)
+      throw std::out_of_range("Invalid slice bounds");
+    if (count == 0) return *this;
+    if (count == size_) return Empty();
+    const int tail_offset = TailOffset();
+    if (count >= tail_offset)
+      return PersistentVector(
+          size_ - count, 0, nullptr,
+          CopyLeaf(tail_.get(), count - tail_offset, size_ - count));
+    auto [root, height] = Shrink(DropNode(root_, height_, count), height_);
+    return PersistentVector(size_ - count, height, std::move(root), tail_);
+  }
+
+  // Elements [begin, end). Throws std::out_of_range unless
+  // 0 <= begin <= end <= Length().
+  [[nodiscard]] PersistentVector Slice(const int begin, const int end) const {
+    if (begin < 0 || begin > end || end > size_)
+      throw std::out_of_range("Invalid slice bounds");
+    return Take(end).Drop(begin);
+  }
+
+  // Call fn with the elements of each leaf, in order, as a
+  // std::span<const T>. Stops early once fn returns false. Used by the
+  // kernels in simd/Scan.h.
+  template <typename Fn>
+  void ForEachChunk(Fn fn) const {
+    if (root_ != nullptr && !ForEachLeaf(root_.get(), height_, fn)) return;
+    if (tail_ != nullptr) fn(std::span<const T>(tail_->Data(), tail_->count_));
+  }
+
+  // Forward iterator that walks one leaf at a time, so it only descends the
+  // tree once per leaf. The vector must outlive it.
+  class const_iterator {
+    const PersistentVector* vector_ = nullptr;
+    int index_ = 0;
+    const T* leaf_ = nullptr;
+    int leaf_begin_ = 0;
+    int leaf_end_ = 0;
+
+    void Seek() {
+      if (index_ >= vector_->size_) return;
+      const auto [leaf, start] = vector_->LeafFor(index_);
+      leaf_ = leaf->Data();
+      leaf_begin_ = start;
+      leaf_end_ = start + leaf->count_;
+    }
+
+    const_iterator(const PersistentVector* vector, const int index)
+        : vector_(vector), index_(index) {
+      Seek();
+    }
+    friend class PersistentVector;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return leaf_[index_ - leaf_begin_]; }
+    pointer operator->() const { return &**this; }
+
+    const_iterator& operator++() {
+      if (++index_ == leaf_end_) Seek();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator before = *this;
+      ++*this;
+      return before;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_;
+    }
+  };
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const { return const_iterator(this, 0); }
+  [[nodiscard]] const_iterator end() const {
+    return const_iterator(this, size_);
+  }
+};
+
+#endif  // VECTOR_PERSISTENT_VECTOR_H
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <execution>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Algorithms.h"
+#include "allocator/PoolAllocator.h"
+
+// Large enough for the parallel overloads to use several chunks.
+constexpr int kLarge = 5 * kMinParallelChunk + 17;
+
+static LinkedList<int> make_list(const int n) {
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < n; i++) builder.Snoc(i);
+  return builder.Build();
+}
+
+template <typename List>
+static std::vector<typename List::const_iterator::value_type> to_vector(
+    const List& list) {
+  return {list.begin(), list.end()};
+}
+
+TEST(AlgorithmsTest, MapAndFilterLists) {
+  const auto list = make_list(10);
+  const auto squares = Map([](const int x) { return x * x; }, list);
+  EXPECT_EQ(to_vector(squares),
+            (std::vector<int>{0, 1, 4, 9, 16, 25, 36, 49, 64, 81}));
+  EXPECT_EQ(squares.Length(), 10);
+
+  const auto names = Map([](const int x) { return std::to_string(x); }, list);
+  static_assert(std::is_same_v<decltype(names), const LinkedList<std::string>>);
+  EXPECT_EQ(names.Index(7), "7");
+
+  const auto odd = Filter([](const int x) { return x % 2 == 1; }, list);
+  EXPECT_EQ(to_vector(odd), (std::vector<int>{1, 3, 5, 7, 9}));
+  EXPECT_EQ(odd.Length(), 5);
+  EXPECT_TRUE(Filter([](int) { return false; }, list).IsEmpty());
+  EXPECT_TRUE(Map([](const int x) { return x; }, LinkedList<int>()).IsEmpty());
+}
+
+TEST(AlgorithmsTest, FoldReduceAndForEach) {
+  const auto list = make_list(5);
+  // FoldLeft is ordered, so non-associative functions are fine.
+  EXPECT_EQ(FoldLeft([](const std::string& acc,
+                        const int x) { return acc + std::to_string(x); },
+                     std::string(">"), list),
+            ">01234");
+  EXPECT_EQ(Reduce(std::plus<>(), 100, list), 110);
+  EXPECT_EQ(Reduce(std::plus<>(), 7, LinkedList<int>()), 7);
+
+  std::vector<int> seen;
+  ForEach([&seen](const int x) { seen.push_back(x); }, list);
+  EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(AlgorithmsTest, ParallelMatchesSequential) {
+  const auto list = make_list(kLarge);
+  const auto add_one = [](const int x) { return x + 1; };
+  const auto keep = [](const int x) { return x % 3 == 0; };
+
+  const auto parallel = Map(std::execution::par, add_one, list);
+  EXPECT_EQ(to_vector(parallel), to_vector(Map(add_one, list)));
+  EXPECT_EQ(parallel.Length(), kLarge);
+  EXPECT_EQ(parallel.Tail().Length(), kLarge - 1);
+
+  const auto filtered = Filter(std::execution::par_unseq, keep, list);
+  EXPECT_EQ(to_vector(filtered), to_vector(Filter(keep, list)));
+  EXPECT_EQ(filtered.Length(), (kLarge + 2) / 3);
+
+  // Concatenation is associative but not commutative, so this checks that
+  // partial results are combined in order.
+  const auto digits =
+      Map([](const int x) { return std::string(1, '0' + x % 10); }, list);
+  EXPECT_EQ(Reduce(std::execution::par, std::plus<>(), std::string(), digits),
+            Reduce(std::plus<>(), std::string(), digits));
+
+  std::atomic<long> sum = 0;  // NOLINT(google-runtime-int)
+  ForEach(std::execution::par, [&sum](const int x) { sum += x; }, list);
+  EXPECT_EQ(sum.load(), static_cast<long>(kLarge) * (kLarge - 1) / 2);
+}
+
+TEST(AlgorithmsTest, ParallelExceptionsPropagate) {
+  const auto list = make_list(kLarge);
+  EXPECT_THROW((void)Map(std::execution::par,
+                         [](const int x) {
+                           if (x == kLarge - 1) throw std::runtime_error("x");
+                           return x;
+                         },
+                         list),
+               std::runtime_error);
+}
+
+TEST(AlgorithmsTest, DequeOverloads) {
+  auto deque = Deque<int>::Empty();
+  for (int i = 1; i < kLarge; i += 2) deque = deque.Snoc(i);
+  deque = deque.Cons(-1);
+  const auto elements = deque.Elements();
+  const std::vector<int> expected(elements.begin(), elements.end());
+
+  const auto doubled = Map(std::execution::par,
+                           [](const int x) { return 2 * x; }, deque);
+  ASSERT_EQ(doubled.Length(), deque.Length());
+  EXPECT_EQ(doubled.Head(), -2);
+  EXPECT_EQ(doubled.Last(), 2 * expected.back());
+  EXPECT_EQ(doubled.Index(100), 2 * expected[100]);
+
+  const auto small = Filter([](const int x) { return x < 10; }, deque);
+  EXPECT_EQ(to_vector(small.ToList()), (std::vector<int>{-1, 1, 3, 5, 7, 9}));
+
+  long total = 0;  // NOLINT(google-runtime-int)
+  for (const int x : expected) total += x;
+  EXPECT_EQ(Reduce(std::execution::par, std::plus<long>(), 0L, deque),
+            total);
+  EXPECT_EQ(FoldLeft([](const int acc, int) { return acc + 1; }, 0, deque),
+            deque.Length());
+  int count = 0;
+  ForEach([&count](int) { count++; }, deque);
+  EXPECT_EQ(count, deque.Length());
+}
+
+TEST(AlgorithmsTest, KeepsAllocatorAndSharing) {
+  using Local = LinkedList<int, PoolAllocator<int>, LocalSharing>;
+  Local::Builder builder;
+  for (int i = 0; i < kLarge; i++) builder.Snoc(i);
+  const Local list = builder.Build();
+  const auto mapped = Map(std::execution::par,
+                          [](const int x) { return x * 0.5; }, list);
+  static_assert(std::is_same_v<
+                decltype(mapped),
+                const LinkedList<double, PoolAllocator<double>, LocalSharing>>);
+  EXPECT_EQ(mapped.Length(), kLarge);
+  EXPECT_EQ(mapped.Index(3), 1.5);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  // Exercise several chunks even on machines with few cores.
+  SetParallelThreads(4);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "atomicref/AtomicRef.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+TEST(AtomicRefTest, LoadStoreExchange) {
+  AtomicRef<LinkedList<int>> ref;
+  EXPECT_TRUE(ref.Load().IsEmpty());
+
+  ref.Store(LinkedList<int>::Single(1));
+  const auto snapshot = ref.Load();
+  EXPECT_EQ(snapshot.Head(), 1);
+
+  const auto previous = ref.Exchange(snapshot.Cons(2));
+  EXPECT_EQ(previous->Head(), 1);
+  EXPECT_EQ(ref.Load().Head(), 2);
+  // Snapshots are unaffected by later publications.
+  EXPECT_EQ(snapshot.Length(), 1);
+}
+
+TEST(AtomicRefTest, CompareExchangeUsesIdentity) {
+  AtomicRef<Deque<int>> ref(Deque<int>::Single(1));
+  auto version = ref.LoadVersion();
+  const auto stale = version;
+
+  EXPECT_TRUE(ref.CompareExchange(version, version->Snoc(2)));
+  EXPECT_EQ(ref.Load().Length(), 2);
+
+  // The stale version is no longer current, so publishing over it fails.
+  auto expected = stale;
+  EXPECT_FALSE(ref.CompareExchange(expected, stale->Snoc(3)));
+  EXPECT_EQ(expected, ref.LoadVersion());
+  EXPECT_EQ(ref.Load().Last(), 2);
+}
+
+TEST(AtomicRefTest, ConcurrentUpdatesAreNotLost) {
+  AtomicRef<Deque<int>> ref;
+  constexpr int kThreads = 4;
+  constexpr int kUpdates = 2000;
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; t++)
+    writers.emplace_back([&ref, t] {
+      for (int i = 0; i < kUpdates; i++)
+        ref.Update([t](const Deque<int>& deque) { return deque.Snoc(t); });
+    });
+  for (auto& writer : writers) writer.join();
+
+  const auto result = ref.Load();
+  EXPECT_EQ(result.Length(), kThreads * kUpdates);
+  std::vector<int> counts(kThreads);
+  for (const int t : result.Elements()) counts[t]++;
+  for (const int count : counts) EXPECT_EQ(count, kUpdates);
+}
+
+TEST(AtomicRefTest, ReadersSeeConsistentSnapshots) {
+  // The producer only ever publishes lists [n, n - 1, ..., 1], so any
+  // snapshot a reader takes must have that shape.
+  AtomicRef<LinkedList<int>> ref;
+  std::atomic<bool> done = false;
+  std::atomic<int> bad = 0;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; r++)
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        const auto snapshot = ref.Load();
+        int expected = snapshot.Length();
+        for (const int element : snapshot)
+          if (element != expected--) bad++;
+      }
+    });
+  for (int i = 1; i <= 5000; i++)
+    ref.Update([i](const LinkedList<int>& list) { return list.Cons(i); });
+  done = true;
+  for (auto& reader : readers) reader.join();
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_EQ(ref.Load().Length(), 5000);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocator/PoolAllocator.h"
+#include "chunkedlist/ChunkedList.h"
+
+// Small chunks so that tests cross node boundaries often.
+using SmallList = ChunkedList<int, 4>;
+
+static std::vector<int> to_vector(const SmallList& list) {
+  return std::vector<int>(list.begin(), list.end());
+}
+
+// Build the list [first, last) by consing from the back.
+static SmallList make_list(const int first, const int last) {
+  SmallList list;
+  for (int i = last - 1; i >= first; i--) list = list.Cons(i);
+  return list;
+}
+
+TEST(ChunkedListTest, DefaultChunkFillsCacheLine) {
+  EXPECT_EQ(kDefaultChunkSize<int>, 16);
+  EXPECT_EQ(kDefaultChunkSize<std::int64_t>, 8);
+  struct Big {
+    char bytes[100];
+  };
+  EXPECT_EQ(kDefaultChunkSize<Big>, 1);
+}
+
+TEST(ChunkedListTest, EmptyAndSingle) {
+  const auto empty = SmallList::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Length(), 0);
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_THROW((void)empty.Head(), std::runtime_error);
+  EXPECT_THROW((void)empty.Tail(), std::runtime_error);
+  EXPECT_THROW((void)empty.Last(), std::runtime_error);
+
+  const auto single = SmallList::Single(7);
+  EXPECT_TRUE(single.IsSingle());
+  EXPECT_EQ(single.Head(), 7);
+  EXPECT_EQ(single.Last(), 7);
+  EXPECT_TRUE(single.Tail().IsEmpty());
+}
+
+TEST(ChunkedListTest, ConsHeadTailAcrossNodes) {
+  const auto list = make_list(0, 11);
+  EXPECT_EQ(list.Length(), 11);
+  auto cur = list;
+  for (int i = 0; i < 11; i++) {
+    ASSERT_EQ(cur.Head(), i);
+    ASSERT_EQ(cur.Length(), 11 - i);
+    cur = cur.Tail();
+  }
+  EXPECT_TRUE(cur.IsEmpty());
+  EXPECT_EQ(list.Last(), 10);
+  for (int i = 0; i < 11; i++) EXPECT_EQ(list.Index(i), i);
+  EXPECT_THROW((void)list.Index(11), std::out_of_range);
+  EXPECT_THROW((void)list.Index(-1), std::out_of_range);
+}
+
+TEST(ChunkedListTest, DivergingConsPreservesVersions) {
+  const auto base = make_list(0, 3);
+  const auto a = base.Cons(100);
+  // a took the free slot in front of base, so b must not overwrite it.
+  const auto b = base.Cons(200);
+  const auto c = a.Cons(300);
+  const auto d = a.Tail().Cons(400);
+
+  EXPECT_EQ(to_vector(base), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(to_vector(a), (std::vector<int>{100, 0, 1, 2}));
+  EXPECT_EQ(to_vector(b), (std::vector<int>{200, 0, 1, 2}));
+  EXPECT_EQ(to_vector(c), (std::vector<int>{300, 100, 0, 1, 2}));
+  EXPECT_EQ(to_vector(d), (std::vector<int>{400, 0, 1, 2}));
+  EXPECT_EQ(&a.Index(1), &base.Head());
+}
+
+TEST(ChunkedListTest, ConcurrentConsOntoSharedVersion) {
+  const auto base = make_list(0, 2);
+  constexpr int kThreads = 4;
+  std::vector<SmallList> results(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++)
+    threads.emplace_back([&, t] {
+      auto list = base;
+      for (int i = 0; i < 1000; i++) list = base.Cons(t);
+      results[t] = list.Cons(t);
+    });
+  for (auto& thread : threads) thread.join();
+  for (int t = 0; t < kThreads; t++)
+    EXPECT_EQ(to_vector(results[t]), (std::vector<int>{t, t, 0, 1}));
+  EXPECT_EQ(to_vector(base), (std::vector<int>{0, 1}));
+}
+
+TEST(ChunkedListTest, ListConversionAndReverse) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const auto chunked = SmallList::FromList(list);
+  EXPECT_EQ(to_vector(chunked), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(to_vector(Reverse(chunked)), (std::vector<int>{3, 2, 1}));
+
+  const auto back = make_list(0, 9).ToList();
+  EXPECT_EQ(std::vector<int>(back.begin(), back.end()),
+            (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST(ChunkedListTest, NonTrivialElements) {
+  auto list = ChunkedList<std::string, 3>::Empty();
+  for (int i = 0; i < 10; i++) list = list.Cons(std::to_string(i));
+  const auto other = list.Tail().Cons("x");
+  EXPECT_EQ(list.Head(), "9");
+  EXPECT_EQ(other.Head(), "x");
+  EXPECT_EQ(other.Index(1), "8");
+  EXPECT_EQ(list.Last(), "0");
+
+  const auto shared = std::make_shared<int>(1);
+  {
+    auto owners = ChunkedList<std::shared_ptr<int>, 3>::Empty();
+    for (int i = 0; i < 7; i++) owners = owners.Cons(shared);
+    EXPECT_EQ(shared.use_count(), 8);
+  }
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(ChunkedListTest, PoliciesAndAllocators) {
+  using Local = ChunkedList<int, 8, PoolAllocator<int>, LocalSharing>;
+  Local list;
+  for (int i = 0; i < 100; i++) list = list.Cons(i);
+  EXPECT_EQ(list.Length(), 100);
+  EXPECT_EQ(list.Head(), 99);
+  EXPECT_EQ(list.Last(), 0);
+}
+
+TEST(ChunkedListTest, DestroyLongList) {
+  auto list = ChunkedList<int, 1>::Empty();
+  for (int i = 0; i < 1'000'000; i++) list = list.Cons(i);
+  EXPECT_EQ(list.Length(), 1'000'000);
+}
+
+static_assert(std::forward_iterator<SmallList::const_iterator>);
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
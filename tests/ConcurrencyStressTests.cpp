@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "atomicref/AtomicRef.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+#include "sharing/Sharing.h"
+
+// Stress tests for versions shared between threads: one writer publishing
+// while many readers take, traverse, keep and drop snapshots. They are most
+// useful under -fsanitize=address or thread, where a count that is dropped
+// too early shows up as a use after free or a race.
+
+static int ReaderThreads() {
+  return std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 4,
+                    16);
+}
+
+// The writer publishes deques sliding along a window of kWindow elements:
+// every version is a run of consecutive integers, each starting no earlier
+// than the last.
+template <typename Sharing>
+static void StressSlidingDeque() {
+  using D = Deque<int, std::allocator<int>, Sharing>;
+  constexpr int kVersions = 20'000;
+  constexpr int kWindow = 256;
+  AtomicRef<D> ref;
+  std::atomic<bool> done = false;
+  std::atomic<int> bad = 0;
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < ReaderThreads(); r++) {
+    readers.emplace_back([&] {
+      // Snapshots kept past any number of later versions, with the first
+      // element each held when it was taken.
+      std::vector<std::pair<D, int>> kept;
+      int last_head = 0;
+      for (bool finished = false; !finished;) {
+        finished = done.load();
+        const D snapshot = ref.Load();
+        if (snapshot.IsEmpty()) continue;
+        if (snapshot.Length() > kWindow) bad++;
+        if (snapshot.Head() < last_head) bad++;
+        last_head = snapshot.Head();
+        int expected = snapshot.Head();
+        for (const int element : snapshot.Elements())
+          if (element != expected++) bad++;
+        if (kept.size() < 64 && snapshot.Head() % 97 == 0)
+          kept.emplace_back(snapshot, snapshot.Head());
+      }
+      for (const auto& [snapshot, head] : kept) {
+        int expected = head;
+        for (const int element : snapshot.Elements())
+          if (element != expected++) bad++;
+      }
+    });
+  }
+
+  D version = D::Empty();
+  for (int i = 0; i < kVersions; i++) {
+    version = version.Snoc(i);
+    if (version.Length() > kWindow) version = version.Tail();
+    ref.Store(version);
+  }
+  done = true;
+  for (std::thread& reader : readers) reader.join();
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_EQ(ref.Load().Length(), kWindow);
+  EXPECT_EQ(ref.Load().Last(), kVersions - 1);
+}
+
+TEST(ConcurrencyStressTest, SlidingDequeWithAtomicSharing) {
+  StressSlidingDeque<AtomicSharing>();
+}
+
+TEST(ConcurrencyStressTest, SlidingDequeWithIntrusiveSharing) {
+  StressSlidingDeque<IntrusiveSharing>();
+}
+
+// Every thread forks versions off the same tail and walks them with Tail(),
+// so all of them update the counts of the tail's nodes at once.
+template <typename Sharing>
+static void StressSharedTail() {
+  using List = LinkedList<int, std::allocator<int>, Sharing>;
+  constexpr int kLength = 1'000;
+  constexpr int kRounds = 200;
+  typename List::Builder builder;
+  for (int i = 0; i < kLength; i++) builder.Snoc(i);
+  const List tail = builder.Build();
+  constexpr int kTailSum = kLength * (kLength - 1) / 2;
+  std::atomic<int> bad = 0;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < ReaderThreads(); t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kRounds; i++) {
+        const List fork = tail.Cons(i).Cons(t);
+        long sum = 0;  // NOLINT(google-runtime-int)
+        for (List cur = fork; !cur.IsEmpty(); cur = cur.Tail())
+          sum += cur.Head();
+        if (sum != kTailSum + i + t) bad++;
+        if (fork.Drop(2 + i) != tail.Drop(i)) bad++;
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  EXPECT_EQ(bad.load(), 0);
+  std::vector<int> expected(kLength);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(std::vector<int>(tail.begin(), tail.end()), expected);
+}
+
+TEST(ConcurrencyStressTest, SharedTailWithAtomicSharing) {
+  StressSharedTail<AtomicSharing>();
+}
+
+TEST(ConcurrencyStressTest, SharedTailWithIntrusiveSharing) {
+  StressSharedTail<IntrusiveSharing>();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
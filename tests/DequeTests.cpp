@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "deque/Deque.h"
@@ -114,6 +121,237 @@ TEST(DequeTest, IndexBounds) {
   EXPECT_THROW(list.Index(100), std::out_of_range);
 }
 
+TEST(DequeTest, LengthAfterRebalancing) {
+  auto deque = Deque<int>::Empty();
+  for (int i = 0; i < 10; i++) deque = deque.Snoc(i);
+  EXPECT_EQ(deque.Length(), 10);
+  // Draining from the front forces rebalances of the back list.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(deque.Head(), i);
+    EXPECT_EQ(deque.Index(0), i);
+    EXPECT_EQ(deque.Length(), 10 - i);
+    deque = deque.Tail();
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(DequeTest, LocalSharingPolicy) {
+  using LocalDeque = Deque<int, std::allocator<int>, LocalSharing>;
+  auto deque = LocalDeque::Empty();
+  for (int i = 0; i < 10; i++) deque = deque.Snoc(i);
+  const auto shared = deque.WithSharing<AtomicSharing>();
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(deque.Head(), i);
+    deque = deque.Tail();
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_EQ(to_vector(shared),
+            std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(DequeTest, BuilderFromEitherEnd) {
+  Deque<int>::Builder snocs;
+  for (int i = 0; i < 5; i++) snocs.Snoc(i);
+  const auto from_snocs = snocs.Build();
+  EXPECT_EQ(to_vector(from_snocs), std::vector<int>({0, 1, 2, 3, 4}));
+  EXPECT_EQ(from_snocs.Length(), 5);
+  EXPECT_EQ(from_snocs.Tail().Head(), 1);
+  EXPECT_EQ(from_snocs.Init().Last(), 3);
+
+  Deque<int>::Builder conses;
+  for (int i = 0; i < 5; i++) conses.Cons(i);
+  EXPECT_EQ(to_vector(conses.Build()), std::vector<int>({4, 3, 2, 1, 0}));
+  EXPECT_TRUE(conses.IsEmpty());
+
+  Deque<int>::Builder mixed;
+  mixed.Cons(2).Snoc(3).Cons(1);
+  EXPECT_EQ(to_vector(mixed.Build()), std::vector<int>({1, 2, 3}));
+}
+
+static_assert(std::forward_iterator<Deque<int>::ElementRange::const_iterator>);
+static_assert(std::ranges::forward_range<Deque<int>::ElementRange>);
+static_assert(std::ranges::sized_range<Deque<int>::ElementRange>);
+
+TEST(DequeTest, ElementRangeTraversal) {
+  auto deque = Deque<int>::Empty();
+  for (int i = 0; i < 6; i++) deque = deque.Snoc(i);
+  deque = deque.Tail().Cons(-1);  // [-1,1,2,3,4,5] after a rebalance
+  const auto elements = deque.Elements();
+  EXPECT_EQ(std::vector<int>(elements.begin(), elements.end()),
+            to_vector(deque));
+  EXPECT_EQ(elements.size(), 6U);
+  EXPECT_EQ(*std::ranges::max_element(elements), 5);
+  EXPECT_EQ(std::ranges::count_if(elements, [](int x) { return x > 2; }), 3);
+
+  const auto single = Deque<int>::Empty().Snoc(7).Elements();
+  EXPECT_EQ(std::vector<int>(single.begin(), single.end()),
+            std::vector<int>({7}));
+  const auto empty = Deque<int>::Empty().Elements();
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(DequeTest, RvalueAndEmplaceOverloads) {
+  using StringDeque = Deque<std::string>;
+  std::string middle = "middle";
+  const auto deque = StringDeque::Single(std::move(middle))
+                         .EmplaceCons(3, 'a')
+                         .EmplaceSnoc("end")
+                         .Cons(std::string("start"));
+  EXPECT_EQ(deque.Length(), 4);
+  EXPECT_EQ(deque.Head(), "start");
+  EXPECT_EQ(deque.Index(1), "aaa");
+  EXPECT_EQ(deque.Index(2), "middle");
+  EXPECT_EQ(deque.Last(), "end");
+  EXPECT_EQ(&deque.Head(), &deque.Index(0));
+}
+
+TEST(DequeTest, DrainLargeDeque) {
+  constexpr int kLength = 1'000'000;
+  auto deque = Deque<int>::Empty();
+  for (int i = 0; i < kLength; i++) deque = deque.Snoc(i);
+  for (int i = 0; i < kLength; i++) {
+    ASSERT_EQ(deque.Head(), i);
+    deque = deque.Tail();
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(DequeTest, ConsumingTailAndInit) {
+  Deque<int>::Builder builder;
+  for (int i = 0; i < 100; i++) builder.Snoc(i);
+  auto deque = builder.Build();
+  const auto kept = deque;
+  for (int i = 0; i < 40; i++) {
+    deque = std::move(deque).Tail();
+    deque = std::move(deque).Init();
+    ASSERT_EQ(deque.Head(), i + 1);
+    ASSERT_EQ(deque.Last(), 98 - i);
+  }
+  EXPECT_EQ(deque.Length(), 20);
+  EXPECT_EQ(kept.Length(), 100);
+  EXPECT_EQ(kept.Head(), 0);
+  EXPECT_EQ(kept.Last(), 99);
+
+  while (!deque.IsEmpty()) deque = std::move(deque).Tail();
+  EXPECT_THROW((void)std::move(deque).Init(), std::invalid_argument);
+  auto copy = kept;
+  EXPECT_EQ(std::move(copy).ToList().Length(), 100);
+  EXPECT_EQ(kept.Length(), 100);
+}
+
+TEST(DequeTest, AppendReusesLargerOperand) {
+  Deque<int>::Builder large_builder;
+  for (int i = 0; i < 1000; i++) large_builder.Snoc(i);
+  const auto large = large_builder.Build();
+  const auto small = Deque<int>::Empty().Snoc(-1).Snoc(-2).Snoc(-3);
+
+  const auto after = large.Append(small);
+  ASSERT_EQ(after.Length(), 1003);
+  EXPECT_EQ(after.Index(999), 999);
+  EXPECT_EQ(after.Last(), -3);
+  // large keeps all of its nodes.
+  EXPECT_EQ(&after.Head(), &large.Head());
+  EXPECT_EQ(&after.Index(999), &large.Index(999));
+
+  const auto before = small.Append(large);
+  ASSERT_EQ(before.Length(), 1003);
+  EXPECT_EQ(before.Head(), -1);
+  EXPECT_EQ(before.Index(3), 0);
+  EXPECT_EQ(&before.Index(3), &large.Index(0));
+  EXPECT_EQ(&before.Last(), &large.Last());
+
+  std::vector<int> expected = to_vector(small);
+  const std::vector<int> large_elements = to_vector(large);
+  expected.insert(expected.end(), large_elements.begin(), large_elements.end());
+  EXPECT_EQ(to_vector(before), expected);
+  EXPECT_EQ(before.Tail().Tail().Tail(), large);
+  EXPECT_EQ(after.Init().Init().Init(), large);
+  EXPECT_EQ(Deque<int>::Single(1).Append(Deque<int>::Single(2)).Last(), 2);
+  EXPECT_EQ(Deque<int>::Empty().Append(small), small);
+}
+
+TEST(DequeTest, EqualityIgnoresSplitPoint) {
+  using List = Deque<int>::List;
+  const List front = List::Empty().Cons(2).Cons(1);
+  // back_ holds the last element first, so both are [1,2,3,4].
+  const Deque<int> a(front, List::Empty().Cons(3).Cons(4));
+  const Deque<int> b(List::Single(1), List::Empty().Cons(2).Cons(3).Cons(4));
+  const Deque<int> c = Deque<int>::FromList(a.ToList());
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(a, a.Snoc(5).Init());
+  EXPECT_NE(a, a.Snoc(5));
+  EXPECT_NE(a, Deque<int>(front, List::Empty().Cons(4).Cons(3)));
+  EXPECT_EQ(Deque<int>::Empty(), Deque<int>::Empty());
+
+  EXPECT_EQ(a <=> b, std::strong_ordering::equal);
+  EXPECT_LT(a, a.Snoc(0));
+  EXPECT_LT(a.Init(), a);
+  EXPECT_GT(a.Tail(), b);
+}
+
+TEST(DequeTest, HashMatchesList) {
+  const Deque<int> a(Deque<int>::List::Empty().Cons(2).Cons(1),
+                     Deque<int>::List::Empty().Cons(3).Cons(4));
+  const auto list = a.ToList();
+  EXPECT_EQ(a.Hash(), list.Hash());
+  EXPECT_EQ(a.Hash(), Deque<int>::FromList(list).Hash());
+  EXPECT_NE(a.Hash(), a.Init().Hash());
+
+  std::unordered_set<Deque<int>> versions = {a, Deque<int>::FromList(list)};
+  EXPECT_EQ(versions.size(), 1);
+  EXPECT_TRUE(versions.contains(a.Snoc(5).Init()));
+}
+
+TEST(DequeTest, ConsAndSnocRanges) {
+  const std::vector<int> batch = {1, 2, 3};
+  const auto deque = Deque<int>::Empty().SnocRange(batch).ConsRange(
+      std::views::iota(-2, 1));
+  EXPECT_EQ(to_vector(deque), std::vector<int>({-2, -1, 0, 1, 2, 3}));
+  EXPECT_EQ(deque.Head(), -2);
+  EXPECT_EQ(deque.Last(), 3);
+  EXPECT_FALSE(deque.Tail().IsEmpty());
+  EXPECT_EQ(to_vector(Deque<int>::Single(0).ConsRange(batch)),
+            std::vector<int>({1, 2, 3, 0}));
+  EXPECT_EQ(to_vector(Deque<int>::Single(0).SnocRange(batch)),
+            std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(deque.SnocRange(std::vector<int>()), deque);
+
+  std::vector<std::string> words = {"a", "b"};
+  const auto moved = Deque<std::string>::Empty().SnocRange(std::move(words));
+  EXPECT_EQ(moved.Head(), "a");
+  EXPECT_EQ(moved.Last(), "b");
+}
+
+TEST(DequeTest, DropAndTakeBatches) {
+  // Deques whose split point sits at the start, middle and end.
+  std::vector<Deque<int>> deques;
+  deques.push_back(Deque<int>::Empty().SnocRange(std::views::iota(0, 20)));
+  deques.push_back(
+      Deque<int>::Empty().ConsRange(std::views::iota(0, 20)).Tail().Init());
+  deques.push_back(Deque<int>::FromList(deques[0].ToList()));
+  for (const auto& deque : deques) {
+    const std::vector<int> elements = to_vector(deque);
+    const int length = deque.Length();
+    for (int n = 0; n <= length; n++) {
+      const std::vector<int> front(elements.begin(), elements.begin() + n);
+      const std::vector<int> rest(elements.begin() + n, elements.end());
+      const std::vector<int> init(elements.begin(), elements.end() - n);
+      EXPECT_EQ(to_vector(deque.DropFront(n)), rest);
+      EXPECT_EQ(to_vector(deque.TakeFront(n)), front);
+      EXPECT_EQ(to_vector(deque.DropBack(n)), init);
+      // Both ends stay usable without another rebalance being needed.
+      if (n + 2 <= length) {
+        EXPECT_EQ(deque.DropFront(n).Last(), elements.back());
+        EXPECT_EQ(deque.DropBack(n).Head(), elements.front());
+      }
+    }
+    EXPECT_THROW((void)deque.DropFront(length + 1), std::out_of_range);
+    EXPECT_THROW((void)deque.DropBack(-1), std::out_of_range);
+    EXPECT_THROW((void)deque.TakeFront(length + 1), std::out_of_range);
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fingertree/FingerTree.h"
+
+using Tree = FingerTree<int>;
+
+static std::vector<int> to_vector(const Tree& tree) {
+  return std::vector<int>(tree.begin(), tree.end());
+}
+
+static Tree make_tree(const int first, const int last) {
+  auto tree = Tree::Empty();
+  for (int i = first; i < last; i++) tree = tree.Snoc(i);
+  return tree;
+}
+
+static std::vector<int> range_vector(const int first, const int last) {
+  std::vector<int> out;
+  for (int i = first; i < last; i++) out.push_back(i);
+  return out;
+}
+
+// Largest element, e.g. the highest priority in a queue.
+struct MaxMeasure {
+  using Value = int;
+  static Value Identity() { return INT_MIN; }
+  static Value Combine(const Value a, const Value b) { return std::max(a, b); }
+  static Value Of(const int element) { return element; }
+};
+
+// Element count and running total together, so that sums can be read off
+// at any position.
+struct SizeSumMeasure {
+  struct Value {
+    int size_;
+    long sum_;  // NOLINT(google-runtime-int)
+  };
+  static Value Identity() { return {0, 0}; }
+  static Value Combine(const Value& a, const Value& b) {
+    return {a.size_ + b.size_, a.sum_ + b.sum_};
+  }
+  static Value Of(const int element) { return {1, element}; }
+  static int Size(const Value& value) { return value.size_; }
+};
+
+TEST(FingerTreeTest, EmptyAndSingle) {
+  const auto empty = Tree::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Length(), 0);
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_THROW((void)empty.Head(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Last(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Tail(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Init(), std::invalid_argument);
+
+  const auto single = Tree::Single(7);
+  EXPECT_EQ(single.Length(), 1);
+  EXPECT_EQ(single.Head(), 7);
+  EXPECT_EQ(single.Last(), 7);
+  EXPECT_TRUE(single.Tail().IsEmpty());
+  EXPECT_TRUE(single.Init().IsEmpty());
+}
+
+TEST(FingerTreeTest, ConsSnocAtBothEnds) {
+  auto tree = Tree::Empty();
+  for (int i = 0; i < 100; i++) tree = tree.Snoc(i).Cons(-i - 1);
+  EXPECT_EQ(tree.Length(), 200);
+  EXPECT_EQ(to_vector(tree), range_vector(-100, 100));
+
+  auto front = tree;
+  for (int i = -100; i < 100; i++) {
+    ASSERT_EQ(front.Head(), i);
+    front = front.Tail();
+  }
+  EXPECT_TRUE(front.IsEmpty());
+  auto back = tree;
+  for (int i = 99; i >= -100; i--) {
+    ASSERT_EQ(back.Last(), i);
+    back = back.Init();
+  }
+  EXPECT_TRUE(back.IsEmpty());
+}
+
+TEST(FingerTreeTest, IndexAndSplitAtEveryPosition) {
+  constexpr int kLength = 300;
+  const auto tree = make_tree(0, kLength);
+  for (int i = 0; i < kLength; i++) ASSERT_EQ(tree.Index(i), i);
+  EXPECT_THROW((void)tree.Index(kLength), std::out_of_range);
+  for (int n = 0; n <= kLength; n++) {
+    const auto [left, right] = tree.SplitAt(n);
+    ASSERT_EQ(to_vector(left), range_vector(0, n));
+    ASSERT_EQ(to_vector(right), range_vector(n, kLength));
+    ASSERT_EQ(left.Length(), n);
+  }
+  EXPECT_THROW((void)tree.SplitAt(kLength + 1), std::out_of_range);
+  EXPECT_THROW((void)tree.SplitAt(-1), std::out_of_range);
+}
+
+TEST(FingerTreeTest, AppendVariousSizes) {
+  for (const int left : {0, 1, 2, 5, 9, 30, 100, 1000}) {
+    for (const int right : {0, 1, 2, 5, 9, 30, 100, 1000}) {
+      const auto joined =
+          make_tree(0, left).Append(make_tree(left, left + right));
+      ASSERT_EQ(to_vector(joined), range_vector(0, left + right));
+      ASSERT_EQ(joined.Length(), left + right);
+    }
+  }
+}
+
+TEST(FingerTreeTest, SplitAndRejoinPreservesVersions) {
+  const auto tree = make_tree(0, 1000);
+  auto rebuilt = Tree::Empty();
+  // Cut into uneven pieces and glue them back together.
+  for (auto rest = tree; !rest.IsEmpty();) {
+    auto [piece, after] = rest.SplitAt(std::min(37, rest.Length()));
+    rebuilt = rebuilt.Append(piece);
+    rest = after;
+  }
+  EXPECT_EQ(to_vector(rebuilt), range_vector(0, 1000));
+  EXPECT_EQ(to_vector(tree), range_vector(0, 1000));
+
+  const auto doubled = tree.Append(tree);
+  EXPECT_EQ(doubled.Length(), 2000);
+  EXPECT_EQ(doubled.Index(1500), 500);
+  EXPECT_EQ(std::distance(doubled.begin(), doubled.end()), 2000);
+}
+
+TEST(FingerTreeTest, MaxMeasureAsPriorityQueue) {
+  auto queue = FingerTree<int, MaxMeasure>::Empty();
+  for (const int priority : {5, 1, 9, 3, 9, 7}) queue = queue.Snoc(priority);
+  EXPECT_EQ(queue.Measured(), 9);
+
+  // Remove the first element with the highest priority.
+  const int top = queue.Measured();
+  const auto [before, from] =
+      queue.Split([top](const int max) { return max >= top; });
+  EXPECT_EQ(from.Head(), 9);
+  const auto rest = before.Append(from.Tail());
+  EXPECT_EQ(std::vector<int>(rest.begin(), rest.end()),
+            (std::vector<int>{5, 1, 3, 9, 7}));
+  EXPECT_EQ(rest.Measured(), 9);
+  EXPECT_EQ(rest.Find([](const int max) { return max >= 9; }), 9);
+  EXPECT_THROW((void)rest.Find([](const int max) { return max > 9; }),
+               std::out_of_range);
+}
+
+TEST(FingerTreeTest, RunningSums) {
+  auto log = FingerTree<int, SizeSumMeasure>::Empty();
+  for (int i = 1; i <= 100; i++) log = log.Snoc(i);
+  EXPECT_EQ(log.Measured().sum_, 5050);
+  EXPECT_EQ(log.Length(), 100);
+  const auto [first, rest] = log.SplitAt(10);
+  EXPECT_EQ(first.Measured().sum_, 55);
+  EXPECT_EQ(rest.Measured().sum_, 5050 - 55);
+
+  // The first point at which the running total exceeds 1000.
+  const auto [under, over] = log.Split(
+      [](const SizeSumMeasure::Value& value) { return value.sum_ > 1000; });
+  EXPECT_EQ(under.Length(), 44);
+  EXPECT_EQ(over.Head(), 45);
+}
+
+TEST(FingerTreeTest, ListAndDequeConversions) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  EXPECT_EQ(to_vector(Tree::FromList(list)), (std::vector<int>{1, 2, 3}));
+  const auto deque = Deque<int>::Empty().Snoc(2).Snoc(3).Cons(1);
+  EXPECT_EQ(to_vector(Tree::FromDeque(deque)), (std::vector<int>{1, 2, 3}));
+
+  const auto tree = make_tree(0, 50);
+  const auto back_to_list = tree.ToList();
+  EXPECT_EQ(std::vector<int>(back_to_list.begin(), back_to_list.end()),
+            range_vector(0, 50));
+  const auto back_to_deque = tree.ToDeque();
+  EXPECT_EQ(back_to_deque.Length(), 50);
+  EXPECT_EQ(back_to_deque.Index(25), 25);
+}
+
+TEST(FingerTreeTest, NonTrivialElements) {
+  auto tree = FingerTree<std::string>::Empty();
+  for (int i = 0; i < 40; i++) tree = tree.Snoc(std::to_string(i));
+  const auto [left, right] = tree.SplitAt(20);
+  EXPECT_EQ(left.Last(), "19");
+  EXPECT_EQ(right.Head(), "20");
+  EXPECT_EQ(right.Append(left).Index(20), "0");
+}
+
+static_assert(std::forward_iterator<Tree::const_iterator>);
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <ranges>
+#include <thread>
+
+#include "deque/Deque.h"
+#include "instrumentation/Instrumentation.h"
+#include "linkedlist/LinkedList.h"
+
+static_assert(kInstrumentationEnabled);
+
+TEST(InstrumentationTest, CountsAllocationsCopiesAndSharing) {
+  ResetInstrumentation();
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  auto counters = ThreadInstrumentation();
+  EXPECT_EQ(counters.node_allocations_, 3);
+  EXPECT_EQ(counters.nodes_copied_, 0);
+  EXPECT_EQ(counters.nodes_shared_, 0 + 1 + 2);
+
+  ResetInstrumentation();
+  const auto appended = list.Append(list);
+  counters = ThreadInstrumentation();
+  EXPECT_EQ(counters.node_allocations_, 3);
+  EXPECT_EQ(counters.nodes_copied_, 3);
+  EXPECT_EQ(counters.nodes_shared_, 3);
+
+  ResetInstrumentation();
+  (void)appended.Init();
+  EXPECT_EQ(ThreadInstrumentation().nodes_copied_, 5);
+}
+
+TEST(InstrumentationTest, CountsTraversalDepth) {
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < 100; i++) builder.Snoc(i);
+  const auto list = builder.Build();
+  ResetInstrumentation();
+  (void)list.Index(9);
+  EXPECT_EQ(ThreadInstrumentation().max_traversal_depth_, 10);
+  (void)list.Last();
+  (void)list.Index(0);
+  EXPECT_EQ(ThreadInstrumentation().max_traversal_depth_, 100);
+}
+
+TEST(InstrumentationTest, CountsRebalances) {
+  // All of these end up on one side, so draining from the other end has to
+  // rebalance.
+  const auto deque =
+      Deque<int>(Deque<int>::List::Empty().Cons(4).Cons(3).Cons(2).Cons(1),
+                 Deque<int>::List::Single(5));
+  ResetInstrumentation();
+  const auto drained = deque.Init();
+  const auto counters = ThreadInstrumentation();
+  EXPECT_EQ(counters.rebalances_, 1);
+  EXPECT_EQ(counters.rebalanced_elements_, 4);
+  EXPECT_EQ(drained.Last(), 4);
+  EXPECT_EQ(drained.Head(), 1);
+}
+
+TEST(InstrumentationTest, BatchDropsRebalanceAtMostOnce) {
+  const auto deque = Deque<int>::Empty().SnocRange(std::views::iota(0, 100));
+  ResetInstrumentation();
+  const auto drained = deque.DropFront(90);
+  EXPECT_EQ(ThreadInstrumentation().rebalances_, 1);
+  EXPECT_EQ(ThreadInstrumentation().rebalanced_elements_, 10);
+  EXPECT_EQ(drained.Head(), 90);
+  EXPECT_EQ(drained.Last(), 99);
+  ResetInstrumentation();
+  (void)deque.DropFront(10).DropBack(10);
+  EXPECT_EQ(ThreadInstrumentation().rebalances_, 0);
+}
+
+TEST(InstrumentationTest, ConsumingUpdatesCopyNothingUniquelyOwned) {
+  auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  ResetInstrumentation();
+  list = std::move(list).Snoc(4);
+  list = std::move(list).Init();
+  auto counters = ThreadInstrumentation();
+  EXPECT_EQ(counters.node_allocations_, 1);
+  EXPECT_EQ(counters.nodes_copied_, 0);
+
+  auto deque = Deque<int>::Empty();
+  for (int i = 0; i < 64; i++) deque = std::move(deque).Snoc(i);
+  ResetInstrumentation();
+  while (!deque.IsEmpty()) deque = std::move(deque).Tail();
+  counters = ThreadInstrumentation();
+  EXPECT_GT(counters.rebalances_, 0);
+  EXPECT_EQ(counters.node_allocations_, 0);
+  EXPECT_EQ(counters.nodes_copied_, 0);
+}
+
+TEST(InstrumentationTest, GlobalCountersIncludeOtherThreads) {
+  ResetInstrumentation();
+  const auto mine = LinkedList<int>::Single(1);
+  std::thread worker([] {
+    auto list = LinkedList<int>::Empty();
+    for (int i = 0; i < 10; i++) list = list.Cons(i);
+    EXPECT_EQ(ThreadInstrumentation().node_allocations_, 10);
+  });
+  worker.join();
+  EXPECT_EQ(ThreadInstrumentation().node_allocations_, 1);
+  // The worker has exited, so its counts live on in the retired total.
+  EXPECT_EQ(GlobalInstrumentation().node_allocations_, 11);
+  ResetInstrumentation();
+  EXPECT_EQ(GlobalInstrumentation().node_allocations_, 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lazylist/LazyList.h"
+#include "linkedlist/LinkedList.h"
+
+template <typename L>
+static std::vector<typename L::const_iterator::value_type> to_vector(
+    const L& list) {
+  return {list.begin(), list.end()};
+}
+
+static const LazyList<int> kNaturals =
+    LazyList<int>::Iterate(0, [](const int x) { return x + 1; });
+
+TEST(LazyListTest, EmptyConsAndAccessors) {
+  const auto empty = LazyList<int>::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Length(), 0);
+  EXPECT_THROW((void)empty.Head(), std::runtime_error);
+  EXPECT_THROW((void)empty.Tail(), std::runtime_error);
+
+  const auto list = empty.Cons(3).Cons(2).Cons(1);
+  EXPECT_EQ(list.Head(), 1);
+  EXPECT_EQ(list.Tail().Head(), 2);
+  EXPECT_EQ(list.Length(), 3);
+  EXPECT_EQ(to_vector(list), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(LazyList<std::string>::Single("x").Head(), "x");
+}
+
+TEST(LazyListTest, InfiniteListsOnlyEvaluateWhatIsTouched) {
+  int calls = 0;
+  const auto squares = kNaturals.Map([&calls](const int x) {
+    calls++;
+    return x * x;
+  });
+  EXPECT_EQ(calls, 0);
+  EXPECT_EQ(to_vector(squares.Take(5)), (std::vector<int>{0, 1, 4, 9, 16}));
+  EXPECT_EQ(calls, 5);
+  // Memoised: walking the same prefix again does not call fn.
+  EXPECT_EQ(squares.Drop(4).Head(), 16);
+  EXPECT_EQ(calls, 5);
+
+  const auto evens = kNaturals.Filter([](const int x) { return x % 2 == 0; });
+  EXPECT_EQ(to_vector(evens.Take(4)), (std::vector<int>{0, 2, 4, 6}));
+  EXPECT_EQ(evens.Drop(1000).Head(), 2000);
+}
+
+TEST(LazyListTest, AppendAndTakeAreIncremental) {
+  bool forced = false;
+  const auto tail = LazyList<int>::Lazy([&forced]() -> LazyList<int>::Value {
+    forced = true;
+    return LazyList<int>::Value(std::in_place, 99, LazyList<int>());
+  });
+  const auto front = LazyList<int>::Empty().Cons(2).Cons(1);
+  const auto joined = front.Append(tail);
+  EXPECT_EQ(to_vector(joined.Take(2)), (std::vector<int>{1, 2}));
+  EXPECT_FALSE(forced);
+  EXPECT_FALSE(tail.IsForced());
+  EXPECT_EQ(to_vector(joined), (std::vector<int>{1, 2, 99}));
+  EXPECT_TRUE(forced);
+
+  EXPECT_TRUE(front.Take(0).IsEmpty());
+  EXPECT_EQ(front.Take(10).Length(), 2);
+  EXPECT_TRUE(front.Drop(5).IsEmpty());
+  // Appending to an infinite list is fine as long as only a prefix is used.
+  EXPECT_EQ(kNaturals.Append(front).Drop(10).Head(), 10);
+}
+
+TEST(LazyListTest, Zip) {
+  const auto names = LazyList<std::string>::Empty().Cons("c").Cons("b").Cons(
+      "a");
+  const auto zipped = kNaturals.Zip(names);
+  EXPECT_EQ(to_vector(zipped),
+            (std::vector<std::pair<int, std::string>>{
+                {0, "a"}, {1, "b"}, {2, "c"}}));
+  EXPECT_TRUE(LazyList<int>().Zip(names).IsEmpty());
+}
+
+TEST(LazyListTest, ConvertsToAndFromLinkedList) {
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < 100; i++) builder.Snoc(i);
+  const auto list = builder.Build();
+  const auto lazy = LazyList<int>::FromList(list);
+  EXPECT_FALSE(lazy.IsForced());
+  EXPECT_EQ(lazy.Drop(50).Head(), 50);
+  // Only the cells walked so far have been evaluated.
+  EXPECT_FALSE(lazy.Drop(51).IsForced());
+  EXPECT_EQ(lazy.ToList(), list);
+  const auto doubled = lazy.Map([](const int x) { return 2 * x; }).ToList();
+  EXPECT_EQ(doubled.Length(), 100);
+  EXPECT_EQ(doubled.Last(), 198);
+}
+
+TEST(LazyListTest, ConcurrentForcingEvaluatesOnce) {
+  std::atomic<int> calls = 0;
+  const auto mapped = kNaturals.Take(1000).Map([&calls](const int x) {
+    calls++;
+    return x + 1;
+  });
+  std::vector<std::thread> threads;
+  std::atomic<long> total = 0;  // NOLINT(google-runtime-int)
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([&] {
+      long sum = 0;  // NOLINT(google-runtime-int)
+      for (const int x : mapped) sum += x;
+      total += sum;
+    });
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(calls.load(), 1000);
+  EXPECT_EQ(total.load(), 4L * 1000 * 1001 / 2);
+}
+
+TEST(LazyListTest, ThrowingThunkCanBeRetried) {
+  int attempts = 0;
+  const auto list = LazyList<int>::Lazy([&attempts]() -> LazyList<int>::Value {
+    if (++attempts == 1) throw std::runtime_error("first time");
+    return LazyList<int>::Value(std::in_place, 7, LazyList<int>());
+  });
+  EXPECT_THROW((void)list.Head(), std::runtime_error);
+  EXPECT_EQ(list.Head(), 7);
+  EXPECT_EQ(attempts, 2);
+}
+
+TEST(LazyListTest, LongForcedListDestructionIsStackSafe) {
+  constexpr int kLength = 300'000;
+  {
+    auto list = kNaturals.Take(kLength);
+    EXPECT_EQ(list.Length(), kLength);
+  }
+  auto built = LazyList<int>::Empty();
+  for (int i = 0; i < kLength; i++) built = built.Cons(i);
+  EXPECT_EQ(built.Head(), kLength - 1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
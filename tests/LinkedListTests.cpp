@@ -1,7 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
+#include "Utils.h"
 #include "linkedlist/LinkedList.h"
 
 // Helper to convert a LinkedList<int> to std::vector<int> for comparisons.
@@ -127,6 +136,425 @@ TEST(LinkedListTest, IndexBounds) {
   EXPECT_THROW((void)list.Index(100), std::out_of_range);
 }
 
+TEST(LinkedListTest, CachedLengthAcrossOperations) {
+  // [1,2,3] and [4,5]
+  const auto base = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const auto other = LinkedList<int>::Empty().Cons(5).Cons(4);
+  EXPECT_EQ(base.Tail().Length(), 2);
+  EXPECT_EQ(base.Append(other).Length(), 5);
+  EXPECT_EQ(base.Append(other).Tail().Length(), 4);
+  EXPECT_EQ(base.Snoc(4).Length(), 4);
+  EXPECT_EQ(base.Init().Length(), 2);
+  EXPECT_TRUE(base.Init().Init().IsSingle());
+  EXPECT_EQ(base.Init().Tail().Length(), 1);
+  // Sharing other as a tail must not disturb its own cached length.
+  EXPECT_EQ(other.Length(), 2);
+}
+
+TEST(LinkedListTest, LongChainDestructionIsStackSafe) {
+  constexpr int kLength = 1'000'000;
+  constexpr int kSharedLength = 10;
+  LinkedList<int> shared_tail = LinkedList<int>::Empty();
+  {
+    auto list = LinkedList<int>::Empty();
+    for (int i = 0; i < kLength; i++) {
+      list = list.Cons(i);
+      if (i == kSharedLength - 1) shared_tail = list;
+    }
+    // list goes out of scope here and releases every unshared node
+  }
+  EXPECT_EQ(shared_tail.Length(), kSharedLength);
+  EXPECT_EQ(shared_tail.Head(), kSharedLength - 1);
+  EXPECT_EQ(shared_tail.Last(), 0);
+}
+
+TEST(LinkedListTest, LocalSharingPolicy) {
+  using LocalList = LinkedList<int, std::allocator<int>, LocalSharing>;
+  const auto base = LocalList::Empty().Cons(3).Cons(2).Cons(1);  // [1,2,3]
+  const auto extended = base.Cons(0);
+  EXPECT_EQ(extended.Length(), 4);
+  EXPECT_EQ(extended.Tail().Head(), 1);
+  EXPECT_EQ(base.Append(base).Index(4), 2);
+  EXPECT_EQ(base.Snoc(4).Last(), 4);
+  EXPECT_EQ(base.Init().Last(), 2);
+  EXPECT_EQ(Reverse(base).Head(), 3);
+  const auto [prefix, suffix] = SplitAt(1, base);
+  EXPECT_EQ(prefix.Length(), 1);
+  EXPECT_EQ(suffix.Head(), 2);
+}
+
+TEST(LinkedListTest, IntrusiveSharingPolicy) {
+  using IntrusiveList = LinkedList<int, std::allocator<int>, IntrusiveSharing>;
+  static_assert(sizeof(IntrusiveList) == sizeof(void*));
+  IntrusiveList::Builder builder;
+  for (int i = 0; i < 1'000; i++) builder.Snoc(i);
+  const auto base = builder.Build();
+
+  // Every thread copies and drops references to the same nodes.
+  std::vector<std::thread> threads;
+  std::vector<int> sums(4);
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&base, &sums, t] {
+      for (int round = 0; round < 20; round++) {
+        const auto mine = base.Cons(t).Tail().Snoc(t);
+        for (IntrusiveList cur = mine; !cur.IsEmpty(); cur = cur.Tail())
+          sums[t] += cur.Head();
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (int t = 0; t < 4; t++) EXPECT_EQ(sums[t], 20 * (999 * 1'000 / 2 + t));
+  EXPECT_EQ(base.Length(), 1'000);
+  EXPECT_EQ(base.Last(), 999);
+
+  auto copy = base;
+  copy = std::move(copy).Snoc(1'000);
+  EXPECT_EQ(copy.Last(), 1'000);
+  EXPECT_EQ(base.Last(), 999);
+  EXPECT_EQ(to_vector(base.WithSharing<AtomicSharing>()).size(), 1'000);
+}
+
+TEST(LinkedListTest, ConvertBetweenSharingPolicies) {
+  using LocalList = LinkedList<int, std::allocator<int>, LocalSharing>;
+  const auto local = LocalList::Empty().Cons(3).Cons(2).Cons(1);  // [1,2,3]
+  const LinkedList<int> shared = local.WithSharing<AtomicSharing>();
+  EXPECT_EQ(to_vector(shared), std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(shared.Length(), 3);
+  const auto back = shared.WithSharing<LocalSharing>();
+  EXPECT_EQ(back.Length(), 3);
+  EXPECT_EQ(back.Last(), 3);
+  EXPECT_TRUE(LinkedList<int>::Empty().WithSharing<LocalSharing>().IsEmpty());
+}
+
+TEST(LinkedListTest, BuilderSnocAndCons) {
+  LinkedList<int>::Builder builder;
+  EXPECT_TRUE(builder.IsEmpty());
+  builder.Snoc(2).Snoc(3).Cons(1).Snoc(4);
+  EXPECT_EQ(builder.Length(), 4);
+  const auto list = builder.Build();
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(list.Length(), 4);
+  EXPECT_EQ(list.Tail().Length(), 3);
+  EXPECT_EQ(list.Last(), 4);
+  // Build() leaves the builder empty and reusable.
+  EXPECT_TRUE(builder.IsEmpty());
+  EXPECT_TRUE(builder.Snoc(9).Build().IsSingle());
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST(LinkedListTest, BuilderAppend) {
+  LinkedList<int>::Builder first;
+  LinkedList<int>::Builder second;
+  first.Snoc(1).Snoc(2);
+  second.Snoc(3).Snoc(4);
+  first.Append(std::move(second));
+  EXPECT_EQ(first.Length(), 4);
+  const auto list = first.Build();
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(list.Tail().Tail().Length(), 2);
+}
+
+TEST(LinkedListTest, BuilderOntoSharedTailAndDrop) {
+  const auto tail = LinkedList<int>::Empty().Cons(4).Cons(3);
+  LinkedList<int>::Builder builder;
+  builder.Snoc(1).Snoc(2);
+  const auto list = builder.BuildOnto(tail);
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(list.Length(), 4);
+  EXPECT_EQ(&list.Index(2), &tail.Head());
+
+  EXPECT_EQ(list.Drop(0), list);
+  EXPECT_EQ(&list.Drop(2).Head(), &tail.Head());
+  EXPECT_EQ(list.Drop(3).Length(), 1);
+  EXPECT_TRUE(list.Drop(4).IsEmpty());
+  EXPECT_THROW((void)list.Drop(5), std::out_of_range);
+  EXPECT_THROW((void)list.Drop(-1), std::out_of_range);
+}
+
+TEST(LinkedListTest, BuilderBulkLoad) {
+  constexpr int kLength = 1'000'000;
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < kLength; i++) builder.Snoc(i);
+  const auto list = builder.Build();
+  EXPECT_EQ(list.Length(), kLength);
+  EXPECT_EQ(list.Head(), 0);
+  EXPECT_EQ(list.Last(), kLength - 1);
+}
+
+static_assert(std::forward_iterator<LinkedList<int>::const_iterator>);
+static_assert(std::ranges::forward_range<LinkedList<int>>);
+
+TEST(LinkedListTest, IteratorTraversal) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  std::vector<int> out;
+  for (const int element : list) out.push_back(element);
+  EXPECT_EQ(out, std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(std::accumulate(list.begin(), list.end(), 0), 6);
+  EXPECT_EQ(std::ranges::distance(list), 3);
+  EXPECT_EQ(*std::ranges::find(list, 2), 2);
+  EXPECT_EQ(std::ranges::find(list, 7), list.end());
+  EXPECT_EQ(LinkedList<int>::Empty().begin(), LinkedList<int>::Empty().end());
+
+  auto it = list.begin();
+  const auto before = it++;
+  EXPECT_EQ(*before, 1);
+  EXPECT_EQ(*it, 2);
+}
+
+TEST(LinkedListTest, RangeAdaptors) {
+  const auto list = LinkedList<int>::Empty().Cons(4).Cons(3).Cons(2).Cons(1);
+  std::vector<int> evens;
+  std::ranges::copy(list | std::views::filter([](int x) { return x % 2 == 0; }),
+                    std::back_inserter(evens));
+  EXPECT_EQ(evens, std::vector<int>({2, 4}));
+}
+
+// Element type that counts how often it is copied.
+struct CopyCounter {
+  static inline int copies = 0;
+  int value;
+  explicit CopyCounter(const int v) : value(v) {}
+  CopyCounter(const CopyCounter& other) : value(other.value) { copies++; }
+  CopyCounter(CopyCounter&& other) noexcept = default;
+  CopyCounter& operator=(const CopyCounter& other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&& other) noexcept = default;
+  ~CopyCounter() = default;
+};
+
+static LinkedList<CopyCounter> CountedList(const int length) {
+  auto list = LinkedList<CopyCounter>::Empty();
+  for (int i = length; i > 0; i--) list = list.EmplaceCons(i);
+  return list;
+}
+
+TEST(LinkedListTest, RvalueAndEmplaceConstruction) {
+  CopyCounter::copies = 0;
+  auto list = LinkedList<CopyCounter>::Single(CopyCounter(3));
+  list = list.Cons(CopyCounter(2)).EmplaceCons(1);
+  list = list.EmplaceSnoc(4);  // Copies the three existing elements.
+  EXPECT_EQ(CopyCounter::copies, 3);
+  EXPECT_EQ(list.Head().value, 1);
+  EXPECT_EQ(list.Last().value, 4);
+  EXPECT_EQ(LinkedList<CopyCounter>::EmplaceSingle(5).Head().value, 5);
+}
+
+TEST(LinkedListTest, AccessorsReturnReferencesIntoNodes) {
+  const auto list = CountedList(3);
+  CopyCounter::copies = 0;
+  EXPECT_EQ(&list.Head(), &list.Index(0));
+  EXPECT_EQ(&list.Last(), &list.Index(2));
+  EXPECT_EQ(&list.Tail().Head(), &list.Index(1));
+  EXPECT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(LinkedListTest, ConsumingOperationsMoveUniqueElements) {
+  const auto other = CountedList(2);
+  CopyCounter::copies = 0;
+  const auto appended = CountedList(3).Append(other);
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(appended.Length(), 5);
+  EXPECT_EQ(appended.Index(3).value, 1);
+
+  const auto reversed = Reverse(CountedList(3));
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(reversed.Head().value, 3);
+
+  const auto [prefix, suffix] = SplitAt(2, CountedList(4));
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(prefix.Last().value, 2);
+  EXPECT_EQ(suffix.Head().value, 3);
+}
+
+TEST(LinkedListTest, ConsumingOperationsCopySharedElements) {
+  auto list = CountedList(3);
+  const auto shared_tail = list.Tail();
+  CopyCounter::copies = 0;
+  // The head is uniquely owned but the two nodes after it are shared.
+  const auto appended = std::move(list).Append(LinkedList<CopyCounter>());
+  EXPECT_EQ(CopyCounter::copies, 2);
+  EXPECT_EQ(appended.Length(), 3);
+  EXPECT_EQ(shared_tail.Head().value, 2);
+  EXPECT_EQ(shared_tail.Last().value, 3);
+
+  CopyCounter::copies = 0;
+  const auto reversed = Reverse(shared_tail);
+  EXPECT_EQ(CopyCounter::copies, 2);
+  EXPECT_EQ(shared_tail.Head().value, 2);
+}
+
+TEST(LinkedListTest, ConsumingEndUpdatesRelinkUniqueNodes) {
+  auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const int* head = &list.Head();
+  list = std::move(list).Snoc(4).Snoc(5);
+  EXPECT_EQ(&list.Head(), head);
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4, 5}));
+  EXPECT_EQ(list.Length(), 5);
+  EXPECT_EQ(list.Tail().Length(), 4);
+
+  list = std::move(list).Init();
+  EXPECT_EQ(&list.Head(), head);
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3, 4}));
+
+  const int* second = &list.Index(1);
+  list = std::move(list).Tail();
+  EXPECT_EQ(&list.Head(), second);
+  EXPECT_EQ(list.Length(), 3);
+
+  // A list sharing its nodes is left as it was.
+  const auto kept = list;
+  const auto grown = std::move(list).Snoc(6);
+  EXPECT_EQ(to_vector(kept), std::vector<int>({2, 3, 4}));
+  EXPECT_EQ(to_vector(grown), std::vector<int>({2, 3, 4, 6}));
+  EXPECT_EQ(to_vector(std::move(grown).Init()), to_vector(kept));
+  EXPECT_EQ(to_vector(kept.Init()), std::vector<int>({2, 3}));
+}
+
+TEST(LinkedListTest, SplitAtSharesSuffix) {
+  const auto list = LinkedList<int>::Empty().Cons(4).Cons(3).Cons(2).Cons(1);
+  const auto [prefix, suffix] = SplitAt(2, list);
+  EXPECT_EQ(to_vector(prefix), std::vector<int>({1, 2}));
+  EXPECT_EQ(to_vector(suffix), std::vector<int>({3, 4}));
+  EXPECT_EQ(prefix.Length(), 2);
+  EXPECT_EQ(prefix.Tail().Length(), 1);
+  EXPECT_EQ(&suffix.Head(), &list.Index(2));
+
+  const auto [all, none] = SplitAt(4, list);
+  EXPECT_EQ(to_vector(all), to_vector(list));
+  EXPECT_TRUE(none.IsEmpty());
+  const auto [empty, whole] = SplitAt(0, list);
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(&whole.Head(), &list.Head());
+
+  EXPECT_THROW((void)SplitAt(-1, list), std::out_of_range);
+  EXPECT_THROW((void)SplitAt(5, list), std::out_of_range);
+}
+
+TEST(LinkedListTest, SplitAndReverse) {
+  const auto list = LinkedList<int>::Empty().Cons(5).Cons(4).Cons(3).Cons(2);
+  const auto [prefix, reversed_suffix] = SplitAndReverse(1, list);
+  EXPECT_EQ(to_vector(prefix), std::vector<int>({2}));
+  EXPECT_EQ(to_vector(reversed_suffix), std::vector<int>({5, 4, 3}));
+  EXPECT_EQ(reversed_suffix.Length(), 3);
+  EXPECT_EQ(reversed_suffix.Tail().Length(), 2);
+
+  const auto [none, all_reversed] = SplitAndReverse(0, list);
+  EXPECT_TRUE(none.IsEmpty());
+  EXPECT_EQ(to_vector(all_reversed), std::vector<int>({5, 4, 3, 2}));
+  EXPECT_THROW((void)SplitAndReverse(5, list), std::out_of_range);
+
+  CopyCounter::copies = 0;
+  const auto [counted_prefix, counted_suffix] =
+      SplitAndReverse(2, CountedList(5));
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(counted_prefix.Last().value, 2);
+  EXPECT_EQ(counted_suffix.Head().value, 5);
+}
+
+TEST(LinkedListTest, SplitLongListIsStackSafe) {
+  constexpr int kLength = 1'000'000;
+  LinkedList<int>::Builder builder;
+  for (int i = 0; i < kLength; i++) builder.Snoc(i);
+  const auto list = builder.Build();
+  const auto [prefix, suffix] = SplitAt(kLength / 2, list);
+  EXPECT_EQ(prefix.Length(), kLength / 2);
+  EXPECT_EQ(prefix.Last(), kLength / 2 - 1);
+  EXPECT_EQ(suffix.Head(), kLength / 2);
+}
+
+TEST(LinkedListTest, EqualityAndOrdering) {
+  const auto shared = LinkedList<int>::Empty().Cons(3).Cons(2);  // [2,3]
+  const auto a = shared.Cons(1);
+  const auto b = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a, a.Tail().Cons(1));
+  EXPECT_NE(a, shared);
+  EXPECT_NE(a, shared.Cons(0));
+  EXPECT_EQ(LinkedList<int>::Empty(), LinkedList<int>());
+
+  EXPECT_LT(shared.Cons(0), a);
+  EXPECT_LT(shared, shared.Snoc(4));  // a proper prefix orders first
+  EXPECT_GT(shared, a);
+  EXPECT_EQ(a <=> b, std::strong_ordering::equal);
+  EXPECT_LT(LinkedList<int>::Empty(), shared);
+  EXPECT_LT(LinkedList<std::string>::Single("a"),
+            LinkedList<std::string>::Single("b"));
+}
+
+TEST(LinkedListTest, HashAgreesWithEquality) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const auto copy = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  EXPECT_EQ(std::hash<LinkedList<int>>{}(list), copy.Hash());
+  EXPECT_NE(list.Hash(), Reverse(list).Hash());
+  EXPECT_NE(list.Hash(), list.Tail().Hash());
+  EXPECT_NE(LinkedList<int>::Single(0).Hash(), LinkedList<int>().Hash());
+
+  std::unordered_set<LinkedList<int>> versions = {list, copy, list.Tail()};
+  EXPECT_EQ(versions.size(), 2);
+  EXPECT_TRUE(versions.contains(list.Tail().Cons(1)));
+}
+
+// Counts std::hash calls and opts in to cached per-node hashes.
+struct HashCounter {
+  static inline int hashes = 0;
+  int value;
+  bool operator==(const HashCounter& other) const = default;
+};
+
+template <>
+struct std::hash<HashCounter> {
+  std::size_t operator()(const HashCounter& counter) const {
+    HashCounter::hashes++;
+    return std::hash<int>{}(counter.value);
+  }
+};
+
+template <>
+inline constexpr bool kCacheListHash<HashCounter> = true;
+
+TEST(LinkedListTest, CachedHashesOnlyHashNewPrefixes) {
+  using CachedList = LinkedList<HashCounter>;
+  static_assert(sizeof(CachedList) == sizeof(LinkedList<int>));
+  CachedList::Builder builder;
+  for (int i = 0; i < 1000; i++) builder.Snoc(HashCounter{i});
+  const auto base = builder.Build();
+
+  HashCounter::hashes = 0;
+  const std::size_t base_hash = base.Hash();
+  EXPECT_EQ(HashCounter::hashes, 1000);
+  EXPECT_EQ(base.Hash(), base_hash);
+  EXPECT_EQ(HashCounter::hashes, 1000);
+
+  HashCounter::hashes = 0;
+  const auto extended = base.Cons(HashCounter{-1}).Cons(HashCounter{-2});
+  (void)extended.Hash();
+  EXPECT_EQ(HashCounter::hashes, 2);
+
+  // Cached hashes match hashing from scratch.
+  CachedList::Builder fresh;
+  for (const HashCounter& counter : extended) fresh.Snoc(counter);
+  EXPECT_EQ(fresh.Build().Hash(), extended.Hash());
+  EXPECT_NE(extended.Hash(), base_hash);
+
+  LinkedList<int>::Builder plain;
+  for (int i = -2; i < 1000; i++) plain.Snoc(i);
+  EXPECT_EQ(plain.Build().Hash(), extended.Hash());
+}
+
+TEST(LinkedListTest, ConsumingEndUpdatesRefreshCachedHashes) {
+  using CachedList = LinkedList<HashCounter>;
+  auto list = CachedList::Empty().Cons(HashCounter{2}).Cons(HashCounter{1});
+  (void)list.Hash();
+  const auto expected = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  list = std::move(list).Snoc(HashCounter{3});
+  EXPECT_EQ(list.Hash(), expected.Hash());
+  list = std::move(list).Init();
+  EXPECT_EQ(list.Hash(), expected.Init().Hash());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chunkedlist/ChunkedList.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+#include "memory/MemoryStats.h"
+#include "sharing/Sharing.h"
+
+// Bytes handed out by every rebinding of CountingAllocator.
+static std::size_t allocated_bytes = 0;
+
+// Stateless allocator that tallies the bytes it hands out.
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& /*other*/) {}  // NOLINT
+
+  T* allocate(const std::size_t n) {
+    allocated_bytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, const std::size_t n) {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& /*other*/) const {
+    return true;
+  }
+};
+
+template <typename List>
+static void ExpectBytesMatchAllocations(const int nodes) {
+  allocated_bytes = 0;
+  auto list = List::Empty();
+  for (int i = 0; i < 100; i++) list = list.Cons(i);
+  const MemoryStats stats = MeasureMemory(list);
+  EXPECT_EQ(stats.nodes_, nodes);
+  EXPECT_EQ(stats.bytes_, allocated_bytes);
+  EXPECT_EQ(stats.unique_bytes_, stats.bytes_);
+  EXPECT_EQ(stats.SharedBytes(), 0);
+}
+
+TEST(MemoryStatsTest, BytesMatchAllocations) {
+  ExpectBytesMatchAllocations<
+      LinkedList<int, CountingAllocator<int>, AtomicSharing>>(100);
+  ExpectBytesMatchAllocations<
+      LinkedList<int, CountingAllocator<int>, LocalSharing>>(100);
+  ExpectBytesMatchAllocations<
+      ChunkedList<int, 16, CountingAllocator<int>, AtomicSharing>>(7);
+  ExpectBytesMatchAllocations<
+      Deque<int, CountingAllocator<int>, LocalSharing>>(100);
+}
+
+TEST(MemoryStatsTest, SharedSuffixIsNotUnique) {
+  const auto empty = LinkedList<int>::Empty();
+  EXPECT_EQ(MeasureMemory(empty), MemoryStats());
+
+  auto base = empty;
+  for (int i = 0; i < 100; i++) base = base.Cons(i);
+  const auto extended = base.Cons(-1).Cons(-2);
+  const auto other = base.Tail().Cons(7);
+  const std::vector versions{base, other};
+
+  const MemoryStats stats = MeasureMemory(extended, versions);
+  EXPECT_EQ(stats.nodes_, 102);
+  EXPECT_EQ(stats.unique_nodes_, 2);
+  EXPECT_EQ(stats.SharedBytes(), MeasureMemory(base).bytes_);
+  EXPECT_EQ(MeasureMemory(base, std::vector{extended}).unique_nodes_, 0);
+  EXPECT_EQ(MeasureMemory(other, versions).unique_nodes_, 0);
+  EXPECT_EQ(MeasureMemory(other, std::vector{base}).unique_nodes_, 1);
+
+  const std::vector all{base, extended, other};
+  const MemoryStats total = MeasureTotalMemory(all);
+  EXPECT_EQ(total.nodes_, 100 + 2 + 1);
+  EXPECT_EQ(total.unique_bytes_, total.bytes_);
+}
+
+TEST(MemoryStatsTest, DequeVersions) {
+  std::vector<Deque<int>> versions{Deque<int>::Empty()};
+  for (int i = 0; i < 1'000; i++) versions.push_back(versions.back().Snoc(i));
+  const MemoryStats last = MeasureMemory(versions.back(), versions);
+  EXPECT_EQ(last.nodes_, 1'000);
+  EXPECT_EQ(last.unique_nodes_, 0);
+
+  // Each Snoc adds one node to back_ and shares the rest, apart from the
+  // nodes that rebalancing copied early on.
+  const MemoryStats total = MeasureTotalMemory(versions);
+  EXPECT_GE(total.nodes_, 1'000);
+  EXPECT_LT(total.nodes_, 1'010);
+
+  // Init shares what is left of back_, but this Tail empties front_ and so
+  // rebalances, copying the rest of the deque.
+  const auto init = versions.back().Init();
+  EXPECT_EQ(MeasureMemory(init, versions).unique_nodes_, 0);
+  const auto tail = versions.back().Tail();
+  EXPECT_EQ(MeasureMemory(tail, versions).unique_nodes_, 999);
+}
+
+TEST(MemoryStatsTest, ChunkingSavesMemory) {
+  auto list = LinkedList<int>::Empty();
+  auto chunked = ChunkedList<int>::Empty();
+  for (int i = 0; i < 10'000; i++) {
+    list = list.Cons(i);
+    chunked = chunked.Cons(i);
+  }
+  const MemoryStats list_stats = MeasureMemory(list);
+  const MemoryStats chunked_stats = MeasureMemory(chunked);
+  EXPECT_EQ(list_stats.nodes_, 10'000);
+  EXPECT_LT(chunked_stats.nodes_, list_stats.nodes_ / 4);
+  EXPECT_LT(chunked_stats.bytes_, list_stats.bytes_ / 2);
+}
+
+TEST(MemoryStatsTest, IntrusiveNodesAreCompact) {
+  auto atomic = LinkedList<std::int64_t>::Empty();
+  auto intrusive =
+      LinkedList<std::int64_t, std::allocator<std::int64_t>,
+                 IntrusiveSharing>::Empty();
+  for (int i = 0; i < 1'000; i++) {
+    atomic = atomic.Cons(i);
+    intrusive = intrusive.Cons(i);
+  }
+  // The count and the cached length share a word, followed by the element
+  // and the pointer to the next node.
+  EXPECT_EQ(MeasureMemory(intrusive).bytes_,
+            1'000 * (8 + sizeof(std::int64_t) + sizeof(void*)));
+  EXPECT_LT(MeasureMemory(intrusive).bytes_ * 3,
+            MeasureMemory(atomic).bytes_ * 2);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "allocator/PoolAllocator.h"
+#include "hashmap/PersistentHashMap.h"
+#include "sharing/Sharing.h"
+
+template <typename Map>
+static std::map<typename Map::Entry::first_type,
+                typename Map::Entry::second_type>
+to_map(const Map& map) {
+  return {map.begin(), map.end()};
+}
+
+// Sends every key to one of four hashes, so that most keys collide fully.
+struct CollidingHash {
+  std::size_t operator()(const int key) const {
+    return static_cast<std::size_t>(key % 4) * 0x9e3779b97f4a7c15;
+  }
+};
+
+TEST(PersistentHashMapTest, InsertFindErase) {
+  const auto empty = PersistentHashMap<std::string, int>::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Find("a"), nullptr);
+  EXPECT_EQ(empty.begin(), empty.end());
+
+  const auto one = empty.Insert("a", 1);
+  const auto two = one.Insert("b", 2);
+  const auto replaced = two.Insert("a", 10);
+  EXPECT_EQ(one.Size(), 1);
+  EXPECT_EQ(two.Size(), 2);
+  EXPECT_EQ(replaced.Size(), 2);
+  EXPECT_EQ(two.At("a"), 1);
+  EXPECT_EQ(replaced.At("a"), 10);
+  EXPECT_EQ(*replaced.Find("b"), 2);
+  EXPECT_FALSE(two.Contains("c"));
+  EXPECT_THROW((void)two.At("c"), std::out_of_range);
+
+  const auto erased = replaced.Erase("a");
+  EXPECT_EQ(erased.Size(), 1);
+  EXPECT_FALSE(erased.Contains("a"));
+  EXPECT_TRUE(erased.Contains("b"));
+  EXPECT_EQ(erased.Erase("missing").Size(), 1);
+  EXPECT_TRUE(erased.Erase("b").IsEmpty());
+  // Older versions are unaffected.
+  EXPECT_EQ(replaced.At("a"), 10);
+  EXPECT_EQ(empty.Size(), 0);
+}
+
+TEST(PersistentHashMapTest, UpdatesShareUntouchedValues) {
+  auto map = PersistentHashMap<int, int>::Empty();
+  for (int i = 0; i < 10'000; i++) map = map.Insert(i, i * i);
+  const auto updated = map.Insert(5, -1).Erase(6);
+  int shared = 0;
+  for (int i = 0; i < 10'000; i++) {
+    if (i == 5 || i == 6) continue;
+    if (map.Find(i) == updated.Find(i)) shared++;
+  }
+  // Only the entries on the copied paths live in new nodes.
+  EXPECT_GT(shared, 9'900);
+  EXPECT_EQ(map.At(5), 25);
+  EXPECT_EQ(updated.At(5), -1);
+}
+
+TEST(PersistentHashMapTest, FullHashCollisions) {
+  auto map = PersistentHashMap<int, int, CollidingHash>::Empty();
+  for (int i = 0; i < 100; i++) map = map.Insert(i, i + 1);
+  EXPECT_EQ(map.Size(), 100);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(map.At(i), i + 1);
+  EXPECT_FALSE(map.Contains(100));
+  EXPECT_EQ(map.Insert(7, 0).At(7), 0);
+  EXPECT_EQ(map.Insert(7, 0).Size(), 100);
+
+  auto erased = map;
+  for (int i = 0; i < 100; i += 2) erased = erased.Erase(i);
+  EXPECT_EQ(erased.Size(), 50);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(erased.Contains(i), i % 2 == 1);
+  EXPECT_EQ(to_map(erased).size(), 50);
+}
+
+TEST(PersistentHashMapTest, MatchesUnorderedMap) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> key(0, 2'000);
+  std::uniform_int_distribution<int> op(0, 2);
+  auto map = PersistentHashMap<int, int>::Empty();
+  std::unordered_map<int, int> expected;
+  for (int step = 0; step < 20'000; step++) {
+    const int k = key(rng);
+    if (op(rng) == 0) {
+      map = map.Erase(k);
+      expected.erase(k);
+    } else {
+      map = map.Insert(k, step);
+      expected[k] = step;
+    }
+    ASSERT_EQ(map.Size(), static_cast<int>(expected.size()));
+  }
+  EXPECT_EQ(to_map(map), (std::map<int, int>(expected.begin(),
+                                              expected.end())));
+  // The iterator visits each entry exactly once.
+  EXPECT_EQ(std::distance(map.begin(), map.end()), map.Size());
+}
+
+TEST(PersistentHashMapTest, BuilderLeavesSourceUntouched) {
+  PersistentHashMap<int, int>::Builder builder;
+  for (int i = 0; i < 1'000; i++) builder.Insert(i, i);
+  builder.Erase(0).Erase(1'000);
+  EXPECT_EQ(builder.Size(), 999);
+  const auto built = builder.Build();
+  EXPECT_TRUE(builder.IsEmpty());
+  EXPECT_EQ(built.Size(), 999);
+  EXPECT_FALSE(built.Contains(0));
+
+  const auto before = to_map(built);
+  PersistentHashMap<int, int>::Builder edit(built);
+  for (int i = 0; i < 1'000; i += 3) edit.Insert(i, -i);
+  for (int i = 1; i < 1'000; i += 3) edit.Erase(i);
+  EXPECT_EQ(*edit.Find(3), -3);
+  const auto edited = std::move(edit).Build();
+  EXPECT_EQ(to_map(built), before);
+  EXPECT_EQ(edited.At(999), -999);
+  EXPECT_FALSE(edited.Contains(1));
+  EXPECT_EQ(edited.Size(), 334 + 333);
+}
+
+TEST(PersistentHashMapTest, LocalSharingWithPoolAllocator) {
+  using Map =
+      PersistentHashMap<int, std::string, std::hash<int>, std::equal_to<int>,
+                        PoolAllocator<std::pair<const int, std::string>>,
+                        LocalSharing>;
+  auto map = Map::Empty();
+  for (int i = 0; i < 5'000; i++) map = map.Insert(i, std::to_string(i));
+  const auto smaller = map.Erase(42);
+  EXPECT_EQ(map.At(42), "42");
+  EXPECT_FALSE(smaller.Contains(42));
+  EXPECT_EQ(smaller.Size(), 4'999);
+  EXPECT_EQ(std::distance(smaller.begin(), smaller.end()), 4'999);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocator/PoolAllocator.h"
+#include "orderedmap/PersistentOrderedMap.h"
+#include "orderedmap/PersistentOrderedSet.h"
+#include "sharing/Sharing.h"
+
+static_assert(
+    std::ranges::forward_range<PersistentOrderedMap<int, int>::EntryRange>);
+static_assert(std::ranges::forward_range<PersistentOrderedSet<int>>);
+
+template <typename Range>
+static std::vector<int> keys(const Range& range) {
+  std::vector<int> out;
+  for (const auto& entry : range) out.push_back(entry.first);
+  return out;
+}
+
+template <typename Set>
+static std::vector<int> to_vector(const Set& set) {
+  return {set.begin(), set.end()};
+}
+
+static PersistentOrderedSet<int> make_set(const int from, const int to,
+                                          const int step = 1) {
+  auto set = PersistentOrderedSet<int>::Empty();
+  for (int i = from; i < to; i += step) set = set.Insert(i);
+  return set;
+}
+
+TEST(PersistentOrderedMapTest, InsertFindErase) {
+  const auto empty = PersistentOrderedMap<std::string, int>::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_EQ(empty.Find("a"), nullptr);
+
+  const auto map = empty.Insert("b", 2).Insert("a", 1).Insert("c", 3);
+  const auto replaced = map.Insert("a", 10);
+  EXPECT_EQ(map.Size(), 3);
+  EXPECT_EQ(replaced.Size(), 3);
+  EXPECT_EQ(map.At("a"), 1);
+  EXPECT_EQ(replaced.At("a"), 10);
+  EXPECT_THROW((void)map.At("d"), std::out_of_range);
+  EXPECT_EQ(map.begin()->first, "a");
+
+  const auto erased = map.Erase("b");
+  EXPECT_EQ(erased.Size(), 2);
+  EXPECT_FALSE(erased.Contains("b"));
+  EXPECT_TRUE(map.Contains("b"));
+  EXPECT_EQ(erased.Erase("missing").Size(), 2);
+}
+
+TEST(PersistentOrderedMapTest, SortedInsertsStayBalanced) {
+  // An unbalanced tree would degrade to a list and recurse kSize deep.
+  constexpr int kSize = 200'000;
+  auto map = PersistentOrderedMap<int, int>::Empty();
+  for (int i = 0; i < kSize; i++) map = map.Insert(i, -i);
+  EXPECT_EQ(map.Size(), kSize);
+  EXPECT_EQ(map.At(kSize - 1), 1 - kSize);
+  for (int i = 0; i < kSize; i += 2) map = map.Erase(i);
+  EXPECT_EQ(map.Size(), kSize / 2);
+  EXPECT_EQ(map.Select(0).first, 1);
+}
+
+TEST(PersistentOrderedMapTest, RankSelectAndRanges) {
+  auto map = PersistentOrderedMap<int, int>::Empty();
+  for (int i = 0; i < 100; i++) map = map.Insert(i * 10, i);
+  EXPECT_EQ(map.Rank(0), 0);
+  EXPECT_EQ(map.Rank(55), 6);
+  EXPECT_EQ(map.Rank(60), 6);
+  EXPECT_EQ(map.Rank(10'000), 100);
+  EXPECT_EQ(map.Select(6).first, 60);
+  EXPECT_EQ(map.Select(99).second, 99);
+  EXPECT_THROW((void)map.Select(100), std::out_of_range);
+  EXPECT_THROW((void)map.Select(-1), std::out_of_range);
+  for (int i = 0; i < map.Size(); i++)
+    EXPECT_EQ(map.Rank(map.Select(i).first), i);
+
+  EXPECT_EQ(keys(map.Range(15, 50)), std::vector<int>({20, 30, 40}));
+  EXPECT_EQ(map.CountRange(15, 50), 3);
+  EXPECT_TRUE(map.Range(50, 15).empty());
+  EXPECT_EQ(map.CountRange(50, 15), 0);
+  EXPECT_EQ(std::ranges::distance(map.Range(-5, 5'000)), 100);
+  EXPECT_EQ(map.LowerBound(30)->first, 30);
+  EXPECT_EQ(map.UpperBound(30)->first, 40);
+  EXPECT_EQ(map.LowerBound(991), map.end());
+
+  std::vector<int> values;
+  std::ranges::copy(map.Range(100, 200) | std::views::values |
+                        std::views::filter([](int x) { return x % 2 == 0; }),
+                    std::back_inserter(values));
+  EXPECT_EQ(values, std::vector<int>({10, 12, 14, 16, 18}));
+}
+
+TEST(PersistentOrderedMapTest, MatchesStdMap) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> key(0, 3'000);
+  std::uniform_int_distribution<int> op(0, 2);
+  auto map = PersistentOrderedMap<int, int>::Empty();
+  std::map<int, int> expected;
+  for (int step = 0; step < 20'000; step++) {
+    const int k = key(rng);
+    if (op(rng) == 0) {
+      map = map.Erase(k);
+      expected.erase(k);
+    } else {
+      map = map.Insert(k, step);
+      expected[k] = step;
+    }
+    ASSERT_EQ(map.Size(), static_cast<int>(expected.size()));
+  }
+  EXPECT_EQ((std::map<int, int>(map.begin(), map.end())), expected);
+  const auto [below, above] = map.Split(1'500);
+  EXPECT_EQ(below.Size(), static_cast<int>(std::distance(
+                              expected.begin(), expected.lower_bound(1'500))));
+  EXPECT_EQ(below.Size() + above.Size() + (map.Contains(1'500) ? 1 : 0),
+            map.Size());
+}
+
+TEST(PersistentOrderedMapTest, UnionKeepsLeftValues) {
+  auto a = PersistentOrderedMap<int, char>::Empty();
+  auto b = PersistentOrderedMap<int, char>::Empty();
+  for (int i = 0; i < 10; i++) a = a.Insert(i, 'a');
+  for (int i = 5; i < 15; i++) b = b.Insert(i, 'b');
+  const auto both = a.Union(b);
+  EXPECT_EQ(both.Size(), 15);
+  EXPECT_EQ(both.At(7), 'a');
+  EXPECT_EQ(both.At(12), 'b');
+  const auto common = b.Intersection(a);
+  EXPECT_EQ(keys(common), std::vector<int>({5, 6, 7, 8, 9}));
+  EXPECT_EQ(common.At(5), 'b');
+  EXPECT_EQ(keys(a.Difference(b)), std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(PersistentOrderedSetTest, SetOperations) {
+  const auto evens = make_set(0, 1'000, 2);
+  const auto threes = make_set(0, 1'000, 3);
+  std::set<int> even_set(evens.begin(), evens.end());
+  std::set<int> three_set(threes.begin(), threes.end());
+
+  std::vector<int> expected;
+  std::ranges::set_union(even_set, three_set, std::back_inserter(expected));
+  EXPECT_EQ(to_vector(evens.Union(threes)), expected);
+  expected.clear();
+  std::ranges::set_intersection(even_set, three_set,
+                                std::back_inserter(expected));
+  EXPECT_EQ(to_vector(evens.Intersection(threes)), expected);
+  expected.clear();
+  std::ranges::set_difference(even_set, three_set,
+                              std::back_inserter(expected));
+  EXPECT_EQ(to_vector(evens.Difference(threes)), expected);
+
+  EXPECT_EQ(evens.Union(evens).Size(), evens.Size());
+  EXPECT_TRUE(evens.Difference(evens).IsEmpty());
+  EXPECT_TRUE(evens.Intersection(PersistentOrderedSet<int>()).IsEmpty());
+}
+
+TEST(PersistentOrderedSetTest, SmallBatchIntoLargeSet) {
+  const auto large = make_set(0, 100'000);
+  const auto batch = make_set(99'990, 100'010);
+  const auto merged = large.Union(batch);
+  EXPECT_EQ(merged.Size(), 100'010);
+  EXPECT_EQ(merged.Select(100'009), 100'009);
+  EXPECT_EQ(large.Size(), 100'000);
+  EXPECT_EQ(merged.Insert(5).Size(), merged.Size());
+  EXPECT_EQ(to_vector(merged.Range(99'998, 100'002)),
+            std::vector<int>({99'998, 99'999, 100'000, 100'001}));
+}
+
+TEST(PersistentOrderedSetTest, LocalSharingWithPoolAllocator) {
+  using Set = PersistentOrderedSet<int, std::greater<int>, PoolAllocator<int>,
+                                   LocalSharing>;
+  auto set = Set::Empty();
+  for (int i = 0; i < 1'000; i++) set = set.Insert(i);
+  const auto smaller = set.Erase(999);
+  EXPECT_EQ(*set.begin(), 999);
+  EXPECT_EQ(*smaller.begin(), 998);
+  EXPECT_EQ(smaller.Rank(500), 498);
+  EXPECT_EQ(to_vector(set.Range(3, 0)), std::vector<int>({3, 2, 1}));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vector/PersistentVector.h"
+
+// Helper to convert a PersistentVector<int> to std::vector<int>.
+static std::vector<int> to_vector(const PersistentVector<int>& vector) {
+  return std::vector<int>(vector.begin(), vector.end());
+}
+
+static PersistentVector<int> make_vector(const int first, const int last) {
+  auto vector = PersistentVector<int>::Empty();
+  for (int i = first; i < last; i++) vector = vector.Snoc(i);
+  return vector;
+}
+
+static std::vector<int> iota_vector(const int first, const int last) {
+  std::vector<int> out(last - first);
+  std::iota(out.begin(), out.end(), first);
+  return out;
+}
+
+// Check every element through Index as well as through iteration, since the
+// two take different paths through the tree.
+static void expect_contents(const PersistentVector<int>& vector,
+                            const std::vector<int>& expected) {
+  ASSERT_EQ(vector.Length(), static_cast<int>(expected.size()));
+  for (int i = 0; i < vector.Length(); i++)
+    ASSERT_EQ(vector.Index(i), expected[i]) << "at index " << i;
+  EXPECT_EQ(to_vector(vector), expected);
+}
+
+TEST(PersistentVectorTest, EmptyAndSingle) {
+  const auto empty = PersistentVector<int>::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Length(), 0);
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_THROW((void)empty.Index(0), std::out_of_range);
+
+  const auto single = PersistentVector<int>::Single(7);
+  EXPECT_FALSE(single.IsEmpty());
+  EXPECT_EQ(single.Head(), 7);
+  EXPECT_EQ(single.Last(), 7);
+}
+
+TEST(PersistentVectorTest, SnocAndIndexAcrossLevels) {
+  // Enough elements for a tree of height 2 (more than 32 * 32 leaves).
+  constexpr int kLength = 40'000;
+  const auto vector = make_vector(0, kLength);
+  expect_contents(vector, iota_vector(0, kLength));
+  EXPECT_THROW((void)vector.Index(-1), std::out_of_range);
+  EXPECT_THROW((void)vector.Index(kLength), std::out_of_range);
+}
+
+TEST(PersistentVectorTest, SnocPreservesOriginal) {
+  const auto base = make_vector(0, 32);
+  const auto a = base.Snoc(100);
+  const auto b = base.Snoc(200);
+  expect_contents(base, iota_vector(0, 32));
+  EXPECT_EQ(a.Last(), 100);
+  EXPECT_EQ(b.Last(), 200);
+  EXPECT_EQ(a.Length(), 33);
+}
+
+TEST(PersistentVectorTest, UpdatePreservesOriginal) {
+  const auto base = make_vector(0, 2000);
+  const auto in_tree = base.Update(5, -5);
+  const auto in_tail = base.Update(1999, -1999);
+
+  expect_contents(base, iota_vector(0, 2000));
+  EXPECT_EQ(in_tree.Index(5), -5);
+  EXPECT_EQ(in_tree.Index(4), 4);
+  EXPECT_EQ(in_tail.Index(1999), -1999);
+  EXPECT_EQ(in_tail.Index(1998), 1998);
+  EXPECT_THROW((void)base.Update(2000, 0), std::out_of_range);
+}
+
+TEST(PersistentVectorTest, AppendVariousSizes) {
+  const std::vector<int> sizes = {0, 1, 31, 32, 33, 100, 1024, 1057, 5000};
+  for (const int left : sizes) {
+    for (const int right : sizes) {
+      SCOPED_TRACE(std::to_string(left) + " ++ " + std::to_string(right));
+      const auto joined =
+          make_vector(0, left).Append(make_vector(left, left + right));
+      expect_contents(joined, iota_vector(0, left + right));
+    }
+  }
+}
+
+TEST(PersistentVectorTest, RepeatedAppendOfSmallPieces) {
+  // Joining many partial leaves exercises the rebalancing of the seam.
+  auto vector = PersistentVector<int>::Empty();
+  std::vector<int> expected;
+  int next = 0;
+  for (int piece = 0; piece < 300; piece++) {
+    const int length = 1 + (piece * 7) % 45;
+    vector = vector.Append(make_vector(next, next + length));
+    for (int i = 0; i < length; i++) expected.push_back(next + i);
+    next += length;
+  }
+  expect_contents(vector, expected);
+
+  // The result must still support the usual operations.
+  const auto updated = vector.Snoc(-1).Update(1000, -2);
+  EXPECT_EQ(updated.Last(), -1);
+  EXPECT_EQ(updated.Index(1000), -2);
+  EXPECT_EQ(updated.Index(999), expected[999]);
+}
+
+TEST(PersistentVectorTest, TakeDropAndSlice) {
+  constexpr int kLength = 3000;
+  const auto vector = make_vector(0, kLength);
+  for (const int n : {0, 1, 31, 32, 33, 1024, 2990, 2999, 3000}) {
+    SCOPED_TRACE(n);
+    expect_contents(vector.Take(n), iota_vector(0, n));
+    expect_contents(vector.Drop(n), iota_vector(n, kLength));
+  }
+  expect_contents(vector.Slice(100, 2100), iota_vector(100, 2100));
+  expect_contents(vector.Slice(40, 41), iota_vector(40, 41));
+  EXPECT_THROW((void)vector.Take(kLength + 1), std::out_of_range);
+  EXPECT_THROW((void)vector.Drop(-1), std::out_of_range);
+  EXPECT_THROW((void)vector.Slice(10, 5), std::out_of_range);
+
+  // Slices can be grown and joined again.
+  const auto rejoined =
+      vector.Take(1500).Snoc(-1).Append(vector.Drop(1500)).Drop(1);
+  auto expected = iota_vector(1, 1500);
+  expected.push_back(-1);
+  for (int i = 1500; i < kLength; i++) expected.push_back(i);
+  expect_contents(rejoined, expected);
+}
+
+TEST(PersistentVectorTest, ListAndDequeConversions) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const auto from_list = PersistentVector<int>::FromList(list);
+  expect_contents(from_list, {1, 2, 3});
+
+  const auto deque = Deque<int>::Empty().Snoc(2).Snoc(3).Cons(1).Snoc(4);
+  const auto from_deque = PersistentVector<int>::FromDeque(deque);
+  expect_contents(from_deque, {1, 2, 3, 4});
+
+  const auto big =
+      PersistentVector<int>::FromList(make_vector(0, 5000).ToList());
+  expect_contents(big, iota_vector(0, 5000));
+
+  const auto back_to_list = from_deque.ToList();
+  EXPECT_EQ(std::vector<int>(back_to_list.begin(), back_to_list.end()),
+            (std::vector<int>{1, 2, 3, 4}));
+  const auto back_to_deque = big.ToDeque();
+  EXPECT_EQ(back_to_deque.Length(), 5000);
+  EXPECT_EQ(back_to_deque.Head(), 0);
+  EXPECT_EQ(back_to_deque.Last(), 4999);
+  EXPECT_EQ(back_to_deque.Index(2500), 2500);
+}
+
+TEST(PersistentVectorTest, NonTrivialElements) {
+  auto vector = PersistentVector<std::string>::Empty();
+  for (int i = 0; i < 100; i++) vector = vector.Snoc(std::to_string(i));
+  const auto joined = vector.Append(vector).Drop(50).Update(0, "first");
+  EXPECT_EQ(joined.Length(), 150);
+  EXPECT_EQ(joined.Head(), "first");
+  EXPECT_EQ(joined.Index(1), "51");
+  EXPECT_EQ(joined.Last(), "99");
+  EXPECT_EQ(vector.Index(50), "50");
+}
+
+static_assert(std::forward_iterator<PersistentVector<int>::const_iterator>);
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
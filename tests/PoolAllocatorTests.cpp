@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "allocator/PoolAllocator.h"
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+
+using PooledList = LinkedList<int, PoolAllocator<int>>;
+using PooledDeque = Deque<int, PoolAllocator<int>>;
+
+// Helper to convert a PooledList to std::vector<int> for comparisons.
+static std::vector<int> to_vector(PooledList list) {
+  std::vector<int> out;
+  while (!list.IsEmpty()) {
+    out.push_back(list.Head());
+    list = list.Tail();
+  }
+  return out;
+}
+
+TEST(PoolAllocatorTest, ReusesFreedBlocks) {
+  PoolAllocator<long> allocator;
+  long* first = allocator.allocate(1);
+  allocator.deallocate(first, 1);
+  long* second = allocator.allocate(1);
+  EXPECT_EQ(first, second);
+  allocator.deallocate(second, 1);
+}
+
+TEST(PoolAllocatorTest, ArrayAllocationsBypassThePool) {
+  PoolAllocator<int> allocator;
+  int* array = allocator.allocate(8);
+  for (int i = 0; i < 8; i++) array[i] = i;
+  EXPECT_EQ(array[7], 7);
+  allocator.deallocate(array, 8);
+}
+
+TEST(PoolAllocatorTest, AllAllocatorsCompareEqual) {
+  EXPECT_TRUE(PoolAllocator<int>() == PoolAllocator<double>());
+}
+
+TEST(PoolAllocatorTest, PooledLinkedList) {
+  const auto list = PooledList::Empty().Cons(3).Cons(2).Cons(1);  // [1,2,3]
+  EXPECT_EQ(to_vector(list), std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(to_vector(list.Snoc(4)), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(to_vector(list.Init()), std::vector<int>({1, 2}));
+  EXPECT_EQ(to_vector(list.Append(list)),
+            std::vector<int>({1, 2, 3, 1, 2, 3}));
+  EXPECT_EQ(to_vector(Reverse(list)), std::vector<int>({3, 2, 1}));
+}
+
+TEST(PoolAllocatorTest, PooledDeque) {
+  auto deque = PooledDeque::Empty();
+  for (int i = 0; i < 100; i++) deque = deque.Snoc(i);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(deque.Head(), i);
+    deque = deque.Tail();
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(PoolAllocatorTest, NodesOutliveTheirAllocatingThread) {
+  PooledList list;
+  std::thread producer([&list] {
+    for (int i = 0; i < 10000; i++) list = list.Cons(i);
+  });
+  producer.join();
+  EXPECT_EQ(list.Length(), 10000);
+  EXPECT_EQ(list.Head(), 9999);
+  // Released on this thread, into this thread's pool.
+  list = PooledList::Empty();
+
+  // Blocks orphaned by the exited producer are handed to later threads.
+  std::thread consumer([] {
+    PooledList other;
+    for (int i = 0; i < 10000; i++) other = other.Cons(i);
+    EXPECT_EQ(other.Length(), 10000);
+  });
+  consumer.join();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "deque/RealTimeDeque.h"
+
+// Helper to convert a RealTimeDeque<int> to std::vector<int> via ToList().
+static std::vector<int> to_vector(const RealTimeDeque<int>& deque) {
+  std::vector<int> out;
+  auto list = deque.ToList();
+  while (!list.IsEmpty()) {
+    out.push_back(list.Head());
+    list = list.Tail();
+  }
+  return out;
+}
+
+TEST(RealTimeDequeTest, EmptyAndSingle) {
+  const auto empty = RealTimeDeque<int>::Empty();
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty.Length(), 0);
+
+  const auto single = RealTimeDeque<int>::Single(7);
+  EXPECT_FALSE(single.IsEmpty());
+  EXPECT_TRUE(single.IsSingle());
+  EXPECT_EQ(single.Head(), 7);
+  EXPECT_EQ(single.Last(), 7);
+  EXPECT_EQ(single.Length(), 1);
+  EXPECT_TRUE(single.Tail().IsEmpty());
+  EXPECT_TRUE(single.Init().IsEmpty());
+  EXPECT_EQ(to_vector(single), std::vector<int>({7}));
+}
+
+TEST(RealTimeDequeTest, ConsAndSnoc) {
+  auto deque = RealTimeDeque<int>::Empty();
+  deque = deque.Cons(2).Cons(1).Snoc(3).Snoc(4);  // [1,2,3,4]
+  EXPECT_EQ(to_vector(deque), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(deque.Head(), 1);
+  EXPECT_EQ(deque.Last(), 4);
+  EXPECT_EQ(deque.Length(), 4);
+  EXPECT_EQ(to_vector(deque.Tail()), std::vector<int>({2, 3, 4}));
+  EXPECT_EQ(to_vector(deque.Init()), std::vector<int>({1, 2, 3}));
+}
+
+TEST(RealTimeDequeTest, DrainFromEitherEnd) {
+  constexpr int kLength = 1000;
+  auto deque = RealTimeDeque<int>::Empty();
+  for (int i = 0; i < kLength; i++) deque = deque.Snoc(i);
+
+  auto from_front = deque;
+  for (int i = 0; i < kLength; i++) {
+    ASSERT_EQ(from_front.Head(), i);
+    ASSERT_EQ(from_front.Length(), kLength - i);
+    from_front = from_front.Tail();
+  }
+  EXPECT_TRUE(from_front.IsEmpty());
+
+  auto from_back = deque;
+  for (int i = kLength - 1; i >= 0; i--) {
+    ASSERT_EQ(from_back.Last(), i);
+    from_back = from_back.Init();
+  }
+  EXPECT_TRUE(from_back.IsEmpty());
+}
+
+TEST(RealTimeDequeTest, MatchesStdDequeUnderRandomOperations) {
+  std::mt19937 rng(42);  // NOLINT(cert-msc51-cpp)
+  std::uniform_int_distribution<int> op_dist(0, 3);
+  auto deque = RealTimeDeque<int>::Empty();
+  std::deque<int> expected;
+  for (int i = 0; i < 20000; i++) {
+    switch (op_dist(rng)) {
+      case 0:
+        deque = deque.Cons(i);
+        expected.push_front(i);
+        break;
+      case 1:
+        deque = deque.Snoc(i);
+        expected.push_back(i);
+        break;
+      case 2:
+        if (!expected.empty()) {
+          deque = deque.Tail();
+          expected.pop_front();
+        }
+        break;
+      default:
+        if (!expected.empty()) {
+          deque = deque.Init();
+          expected.pop_back();
+        }
+        break;
+    }
+    ASSERT_EQ(deque.Length(), static_cast<int>(expected.size()));
+    if (!expected.empty()) {
+      ASSERT_EQ(deque.Head(), expected.front());
+      ASSERT_EQ(deque.Last(), expected.back());
+    }
+  }
+  EXPECT_EQ(to_vector(deque),
+            std::vector<int>(expected.begin(), expected.end()));
+}
+
+TEST(RealTimeDequeTest, OldVersionsArePreserved) {
+  auto base = RealTimeDeque<int>::Empty();
+  for (int i = 0; i < 100; i++) base = base.Snoc(i);
+  // Replaying operations from the same old version must give the same result
+  // every time and leave the old version untouched.
+  for (int round = 0; round < 3; round++) {
+    auto drained = base;
+    while (drained.Length() > 1) drained = drained.Tail();
+    EXPECT_EQ(drained.Head(), 99);
+  }
+  EXPECT_EQ(base.Length(), 100);
+  EXPECT_EQ(base.Head(), 0);
+  EXPECT_EQ(base.Last(), 99);
+}
+
+TEST(RealTimeDequeTest, ListConversions) {
+  const auto list = LinkedList<int>::Empty().Cons(3).Cons(2).Cons(1);
+  const auto deque = RealTimeDeque<int>::FromList(list);
+  EXPECT_EQ(deque.Length(), 3);
+  EXPECT_EQ(to_vector(deque), std::vector<int>({1, 2, 3}));
+}
+
+TEST(RealTimeDequeTest, EmptyExceptions) {
+  const auto empty = RealTimeDeque<int>::Empty();
+  EXPECT_THROW((void)empty.Head(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Last(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Tail(), std::invalid_argument);
+  EXPECT_THROW((void)empty.Init(), std::invalid_argument);
+}
+
+TEST(RealTimeDequeTest, LargeDequeDestructionIsStackSafe) {
+  auto deque = RealTimeDeque<int>::Empty();
+  for (int i = 0; i < 1'000'000; i++) deque = deque.Snoc(i);
+  EXPECT_EQ(deque.Length(), 1'000'000);
+  EXPECT_EQ(deque.Head(), 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
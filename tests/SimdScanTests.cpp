@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "chunkedlist/ChunkedList.h"
+#include "linkedlist/LinkedList.h"
+#include "simd/Scan.h"
+#include "vector/PersistentVector.h"
+
+static_assert(ChunkScannable<ChunkedList<int>>);
+static_assert(ChunkScannable<PersistentVector<double>>);
+static_assert(!ChunkScannable<LinkedList<int>>);
+static_assert(!kSimdScannable<std::string>);
+static_assert(!kSimdScannable<bool>);
+
+template <typename T>
+static std::vector<T> make_values(const int n) {
+  std::vector<T> values;
+  for (int i = 0; i < n; i++)
+    values.push_back(static_cast<T>((i * 7 + 3) % 23));
+  return values;
+}
+
+template <typename T>
+static void check_kernels() {
+  // Every length up to a few vectors, so that both the vector loop and the
+  // scalar remainder are exercised.
+  for (int n = 0; n < 70; n++) {
+    const std::vector<T> values = make_values<T>(n);
+    const std::span<const T> span(values);
+    for (const T value : {T(3), T(22), T(99)}) {
+      const auto expected = std::find(values.begin(), values.end(), value);
+      EXPECT_EQ(SimdFind(span, value),
+                expected == values.end() ? -1 : expected - values.begin());
+      EXPECT_EQ(SimdCount(span, value),
+                static_cast<std::size_t>(
+                    std::count(values.begin(), values.end(), value)));
+    }
+    EXPECT_EQ(SimdSum(span), std::accumulate(values.begin(), values.end(),
+                                             T{}));
+    if (n == 0) continue;
+    EXPECT_EQ(SimdExtreme(span, std::less<>()),
+              *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(SimdExtreme(span, std::greater<>()),
+              *std::max_element(values.begin(), values.end()));
+  }
+}
+
+TEST(SimdScanTest, KernelsMatchScalarLoops) {
+  check_kernels<int>();
+  check_kernels<std::uint8_t>();
+  check_kernels<std::uint64_t>();
+  check_kernels<float>();
+  check_kernels<double>();
+}
+
+TEST(SimdScanTest, ChunkedList) {
+  constexpr int kLength = 1'000;
+  ChunkedList<int> list;
+  for (int i = kLength - 1; i >= 0; i--) list = list.Cons(i % 100);
+  // Start in the middle of a node.
+  const auto tail = list.Tail().Tail().Tail();
+  EXPECT_EQ(Find(list, 42), 42);
+  EXPECT_EQ(Find(tail, 1), 98);
+  EXPECT_EQ(Find(list, 100), -1);
+  EXPECT_TRUE(Contains(list, 99));
+  EXPECT_FALSE(Contains(list, -1));
+  EXPECT_EQ(Count(list, 7), 10);
+  EXPECT_EQ(Sum(list), 10 * 4'950);
+  EXPECT_EQ(Sum(tail), 10 * 4'950 - 3);
+  EXPECT_EQ(Min(tail), 0);
+  EXPECT_EQ(Max(list), 99);
+
+  const auto empty = ChunkedList<int>::Empty();
+  EXPECT_EQ(Find(empty, 0), -1);
+  EXPECT_EQ(Sum(empty), 0);
+  EXPECT_THROW((void)Min(empty), std::runtime_error);
+  EXPECT_THROW((void)Max(empty), std::runtime_error);
+}
+
+TEST(SimdScanTest, PersistentVector) {
+  constexpr int kLength = 5'000;
+  LinkedList<double>::Builder builder;
+  for (int i = 0; i < kLength; i++) builder.Snoc(i * 0.5);
+  const auto vector = PersistentVector<double>::FromList(builder.Build());
+  // Leaves from the tree and the tail, and a vector that is all tail.
+  EXPECT_EQ(Find(vector, 1'000.0), 2'000);
+  EXPECT_EQ(Find(vector, (kLength - 1) * 0.5), kLength - 1);
+  EXPECT_EQ(Find(vector, 0.25), -1);
+  EXPECT_EQ(Count(vector.Snoc(3.0).Snoc(3.0), 3.0), 3);
+  EXPECT_EQ(Sum(vector), 0.5 * kLength * (kLength - 1) / 2);
+  EXPECT_EQ(Min(vector.Drop(10)), 5.0);
+  EXPECT_EQ(Max(vector.Take(10)), 4.5);
+  EXPECT_EQ(Max(PersistentVector<double>::Single(-1.0)), -1.0);
+  EXPECT_THROW((void)Min(PersistentVector<double>::Empty()),
+               std::runtime_error);
+}
+
+TEST(SimdScanTest, NonArithmeticElementsUseScalarLoops) {
+  ChunkedList<std::string> list;
+  for (const char* s : {"d", "b", "c", "a", "b"}) list = list.Cons(s);
+  EXPECT_EQ(Find(list, std::string("c")), 2);
+  EXPECT_EQ(Count(list, std::string("b")), 2);
+  EXPECT_EQ(Sum(list), "bacbd");
+  EXPECT_EQ(Min(list), "a");
+  EXPECT_EQ(Max(list), "d");
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
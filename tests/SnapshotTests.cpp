@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "deque/Deque.h"
+#include "linkedlist/LinkedList.h"
+#include "serialization/MappedFile.h"
+#include "serialization/Snapshot.h"
+
+// Aligned copy of everything written to out.
+static std::vector<std::uint64_t> to_buffer(const std::ostringstream& out) {
+  const std::string bytes = out.str();
+  std::vector<std::uint64_t> buffer((bytes.size() + 7) / 8);
+  std::memcpy(buffer.data(), bytes.data(), bytes.size());
+  return buffer;
+}
+
+static std::span<const std::byte> as_bytes(
+    const std::vector<std::uint64_t>& buffer) {
+  return std::as_bytes(std::span(buffer));
+}
+
+template <typename List>
+static std::vector<int> to_vector(const List& list) {
+  return {list.begin(), list.end()};
+}
+
+static LinkedList<int> make_list(const int from, const int to) {
+  LinkedList<int>::Builder builder;
+  for (int i = from; i < to; i++) builder.Snoc(i);
+  return builder.Build();
+}
+
+TEST(SnapshotTest, RoundTripSharesTails) {
+  const auto tail = make_list(100, 200);
+  const auto a = tail.Cons(2).Cons(1);
+  const auto b = tail.Cons(3);
+  SnapshotWriter<int> writer;
+  EXPECT_EQ(writer.Add(a), 0);
+  EXPECT_EQ(writer.Add(b), 1);
+  EXPECT_EQ(writer.Add(tail), 2);
+  EXPECT_EQ(writer.Add(LinkedList<int>()), 3);
+  // Every node is written once.
+  EXPECT_EQ(writer.NodeCount(), 103);
+
+  std::ostringstream out;
+  writer.Write(out);
+  const auto buffer = to_buffer(out);
+  const Snapshot<int> snapshot(as_bytes(buffer));
+  ASSERT_EQ(snapshot.RootCount(), 4);
+  snapshot.Validate();
+
+  const auto lists = snapshot.Load();
+  EXPECT_EQ(to_vector(lists[0]), to_vector(a));
+  EXPECT_EQ(lists[1], b);
+  EXPECT_EQ(lists[2].Length(), 100);
+  EXPECT_TRUE(lists[3].IsEmpty());
+  // The shared tail is one set of nodes again after loading.
+  EXPECT_EQ(&lists[0].Tail().Tail().Head(), &lists[2].Head());
+  EXPECT_EQ(&lists[1].Tail().Head(), &lists[2].Head());
+}
+
+TEST(SnapshotTest, ViewsReadInPlace) {
+  const auto list = make_list(0, 1000);
+  SnapshotWriter<int> writer;
+  writer.Add(list);
+  writer.Add(list.Tail().Tail());
+  std::ostringstream out;
+  writer.Write(out);
+  const auto buffer = to_buffer(out);
+  const Snapshot<int> snapshot(as_bytes(buffer));
+
+  const auto view = snapshot.View(0);
+  EXPECT_EQ(view.Length(), 1000);
+  EXPECT_EQ(view.Head(), 0);
+  EXPECT_EQ(view.Index(999), 999);
+  EXPECT_EQ(view.Tail().Tail().Head(), snapshot.View(1).Head());
+  EXPECT_EQ(to_vector(view), to_vector(list));
+  EXPECT_EQ(view.ToList(), list);
+  // Views point straight into the buffer.
+  const auto* first = reinterpret_cast<const std::byte*>(&view.Head());
+  EXPECT_GE(first, as_bytes(buffer).data());
+  EXPECT_LT(first, as_bytes(buffer).data() + as_bytes(buffer).size());
+
+  EXPECT_THROW((void)view.Index(1000), std::out_of_range);
+  EXPECT_THROW((void)snapshot.View(2), std::out_of_range);
+  EXPECT_THROW((void)SnapshotList<int>().Head(), std::runtime_error);
+}
+
+TEST(SnapshotTest, DequeRoundTrip) {
+  auto deque = Deque<int>::Empty();
+  for (int i = 0; i < 50; i++) deque = deque.Snoc(i).Cons(-i);
+  SnapshotWriter<int> writer;
+  const int root = writer.Add(deque);
+  std::ostringstream out;
+  writer.Write(out);
+  const auto buffer = to_buffer(out);
+  const Snapshot<int> snapshot(as_bytes(buffer));
+  EXPECT_EQ(snapshot.LoadDeque(root), deque);
+}
+
+TEST(SnapshotTest, MappedFile) {
+  struct Point {
+    double x;
+    double y;
+  };
+  LinkedList<Point>::Builder builder;
+  for (int i = 0; i < 10'000; i++) builder.Snoc(Point{i * 1.0, -i * 1.0});
+  const auto points = builder.Build();
+  SnapshotWriter<Point> writer;
+  writer.Add(points);
+
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("snapshot_test_" + std::to_string(getpid()));
+  writer.WriteFile(path);
+  {
+    const MappedFile file(path);
+    const Snapshot<Point> snapshot(file.Bytes());
+    const auto view = snapshot.View(0);
+    EXPECT_EQ(view.Length(), 10'000);
+    EXPECT_EQ(view.Index(1234).y, -1234.0);
+    double sum = 0;
+    for (const Point& point : view) sum += point.x;
+    EXPECT_EQ(sum, 9999.0 * 10'000 / 2);
+    // The element type is part of the format.
+    EXPECT_THROW(Snapshot<int>(file.Bytes()), std::runtime_error);
+  }
+  std::filesystem::remove(path);
+  EXPECT_THROW(MappedFile(path.string()), std::system_error);
+}
+
+TEST(SnapshotTest, RejectsMalformedInput) {
+  SnapshotWriter<int> writer;
+  writer.Add(make_list(0, 10));
+  std::ostringstream out;
+  writer.Write(out);
+  auto buffer = to_buffer(out);
+
+  std::vector<std::uint64_t> truncated(buffer.begin(), buffer.end() - 2);
+  EXPECT_THROW(Snapshot<int>(as_bytes(truncated)), std::runtime_error);
+  EXPECT_THROW(Snapshot<int>(as_bytes(buffer).subspan(1)),
+               std::invalid_argument);
+
+  auto bad_magic = buffer;
+  reinterpret_cast<char*>(bad_magic.data())[0] = 'X';
+  EXPECT_THROW(Snapshot<int>(as_bytes(bad_magic)), std::runtime_error);
+
+  // Point the last node (the head) at itself.
+  auto cycle = buffer;
+  const std::size_t nodes_offset = SnapshotNodesOffset<int>(1);
+  auto* nodes = reinterpret_cast<SnapshotNode<int>*>(
+      reinterpret_cast<std::byte*>(cycle.data()) + nodes_offset);
+  nodes[9].next_ = 9;
+  const Snapshot<int> corrupt(as_bytes(cycle));
+  EXPECT_THROW(corrupt.Validate(), std::runtime_error);
+  EXPECT_THROW((void)corrupt.Load(), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
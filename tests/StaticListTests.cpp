@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "linkedlist/LinkedList.h"
+#include "linkedlist/StaticList.h"
+#include "sharing/Sharing.h"
+
+// Allocations made by every rebinding of CountingAllocator.
+static int allocations = 0;
+
+// Stateless allocator that counts the allocations it makes.
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& /*other*/) {}  // NOLINT
+
+  T* allocate(const std::size_t n) {
+    allocations++;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, const std::size_t n) {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& /*other*/) const {
+    return true;
+  }
+};
+
+template <typename List>
+static std::vector<int> to_vector(const List& list) {
+  return std::vector<int>(list.begin(), list.end());
+}
+
+// The list 1, 2, 3 built at run time and from static storage, under Sharing.
+template <typename Sharing>
+static void ExpectSharesAsTail() {
+  using List = LinkedList<int, CountingAllocator<int>, Sharing>;
+  const List runtime = List::Empty().Cons(3).Cons(2).Cons(1);
+
+  allocations = 0;
+  const List primes = StaticList<List, 1, 2, 3>::Get();
+  EXPECT_EQ(allocations, 0);
+  EXPECT_EQ(primes.Length(), 3);
+  EXPECT_EQ(primes.Head(), 1);
+  EXPECT_EQ(primes.Last(), 3);
+  EXPECT_EQ(primes, runtime);
+  EXPECT_EQ(primes.Hash(), runtime.Hash());
+
+  // New nodes in front share every static node.
+  const List more = primes.Cons(0);
+  EXPECT_EQ(allocations, 1);
+  EXPECT_EQ(to_vector(more), std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(more.Drop(1), primes);
+  EXPECT_EQ(to_vector(runtime.Append(primes)),
+            std::vector<int>({1, 2, 3, 1, 2, 3}));
+
+  // Static nodes are never uniquely owned, so consuming updates copy them.
+  List consumed = StaticList<List, 1, 2, 3>::Get();
+  const List longer = std::move(consumed).Snoc(4);
+  EXPECT_EQ(to_vector(longer), std::vector<int>({1, 2, 3, 4}));
+  EXPECT_EQ(to_vector(StaticList<List, 1, 2, 3>::Get()),
+            std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(to_vector(StaticList<List, 1, 2, 3>::Get().Tail().Cons(5)),
+            std::vector<int>({5, 2, 3}));
+}
+
+TEST(StaticListTest, SharesAsTailWithAtomicSharing) {
+  ExpectSharesAsTail<AtomicSharing>();
+}
+
+TEST(StaticListTest, SharesAsTailWithIntrusiveSharing) {
+  ExpectSharesAsTail<IntrusiveSharing>();
+}
+
+TEST(StaticListTest, SharesAsTailWithLocalSharing) {
+  ExpectSharesAsTail<LocalSharing>();
+}
+
+TEST(StaticListTest, EmptyAndShorthand) {
+  static_assert(StaticList<LinkedList<int>>::Length() == 0);
+  EXPECT_TRUE(StaticList<LinkedList<int>>::Get().IsEmpty());
+
+  static_assert(StaticList<LinkedList<long>, 1, 2>::Length() == 2);
+  const LinkedList<long> longs = StaticList<LinkedList<long>, 1, 2>::Get();
+  EXPECT_EQ(longs.Index(1), 2L);
+
+  const LinkedList<char> letters = MakeStaticList<'a', 'b', 'c'>();
+  EXPECT_EQ(letters.Length(), 3);
+  EXPECT_EQ(letters.Index(2), 'c');
+  // Every Get() returns the same nodes.
+  const LinkedList<char> again = MakeStaticList<'a', 'b', 'c'>();
+  EXPECT_EQ(&again.Head(), &letters.Head());
+}
+
+TEST(StaticListTest, OutlivesEveryVersionSharingIt) {
+  using List = LinkedList<int, std::allocator<int>, IntrusiveSharing>;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 10'000; i++) {
+        const List version = StaticList<List, 7, 8, 9>::Get().Cons(i);
+        ASSERT_EQ(version.Index(1), 7);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  EXPECT_EQ(to_vector(StaticList<List, 7, 8, 9>::Get()),
+            std::vector<int>({7, 8, 9}));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atomicref/AtomicRef.h"
+#include "deque/Deque.h"
+#include "stream/Generator.h"
+#include "stream/StreamPublisher.h"
+
+static Generator<int> Iota(const int n) {
+  for (int i = 0; i < n; i++) co_yield i;
+}
+
+static Generator<std::string> ThrowsAfter(const int n) {
+  for (int i = 0; i < n; i++) co_yield std::to_string(i);
+  throw std::runtime_error("source failed");
+}
+
+static std::vector<int> to_vector(const Deque<int>& deque) {
+  std::vector<int> out;
+  for (const int element : deque.Elements()) out.push_back(element);
+  return out;
+}
+
+// Hours, so that only the element count triggers a snapshot.
+static constexpr PublishPolicy kEveryTen{10, std::chrono::hours(1)};
+
+TEST(StreamPublisherTest, GeneratorYieldsInOrder) {
+  static_assert(std::ranges::input_range<Generator<int>>);
+  std::vector<int> seen;
+  for (const int i : Iota(5)) seen.push_back(i);
+  EXPECT_EQ(seen, std::vector<int>({0, 1, 2, 3, 4}));
+  for ([[maybe_unused]] const int i : Iota(0)) FAIL();
+
+  std::vector<std::string> before_throw;
+  EXPECT_THROW(
+      {
+        for (const std::string& s : ThrowsAfter(2)) before_throw.push_back(s);
+      },
+      std::runtime_error);
+  EXPECT_EQ(before_throw, std::vector<std::string>({"0", "1"}));
+}
+
+TEST(StreamPublisherTest, PublishesEveryKElements) {
+  AtomicRef<Deque<int>> ref;
+  StreamPublisher<Deque<int>> publisher(ref, kEveryTen);
+  for (int i = 0; i < 9; i++) publisher.Push(i);
+  EXPECT_TRUE(ref.Load().IsEmpty());
+  EXPECT_EQ(publisher.Pending(), 9);
+  publisher.Push(9);
+  EXPECT_EQ(ref.Load().Length(), 10);
+  EXPECT_EQ(publisher.Pending(), 0);
+  const auto first = ref.Load();
+
+  for (int i = 10; i < 25; i++) publisher.Push(i);
+  EXPECT_EQ(ref.Load().Length(), 20);
+  publisher.Flush();
+  EXPECT_EQ(ref.Load().Length(), 25);
+  EXPECT_EQ(publisher.Finish().Length(), 25);
+  // Earlier snapshots are unaffected by later pushes.
+  EXPECT_EQ(to_vector(first), to_vector(Deque<int>::Empty().SnocRange(
+                                  std::views::iota(0, 10))));
+  EXPECT_EQ(to_vector(ref.Load()).back(), 24);
+}
+
+TEST(StreamPublisherTest, PublishesAfterInterval) {
+  AtomicRef<Deque<int>> ref;
+  // Zero interval: every element is due at once.
+  StreamPublisher<Deque<int>> publisher(ref, {1'000, {}});
+  for (int i = 0; i < 3; i++) {
+    publisher.Push(i);
+    EXPECT_EQ(ref.Load().Length(), i + 1);
+  }
+}
+
+TEST(StreamPublisherTest, ContinuesFromCurrentVersion) {
+  AtomicRef<Deque<int>> ref(Deque<int>::Empty().Snoc(-2).Snoc(-1));
+  const auto result = PublishStream(ref, Iota(3), kEveryTen);
+  EXPECT_EQ(to_vector(result), std::vector<int>({-2, -1, 0, 1, 2}));
+  EXPECT_EQ(to_vector(ref.Load()), to_vector(result));
+}
+
+TEST(StreamPublisherTest, ReadersSeeConsistentPrefixes) {
+  constexpr int kElements = 100'000;
+  AtomicRef<Deque<int>> ref;
+  std::atomic<bool> done = false;
+  std::atomic<int> snapshots_checked = 0;
+
+  std::thread reader([&] {
+    int last_length = 0;
+    // The last round starts after the final version is out.
+    for (bool finished = false; !finished;) {
+      finished = done.load();
+      const auto snapshot = ref.Load();
+      ASSERT_GE(snapshot.Length(), last_length);
+      last_length = snapshot.Length();
+      if (snapshot.IsEmpty()) continue;
+      // Every published snapshot is a whole prefix of the stream.
+      ASSERT_EQ(snapshot.Head(), 0);
+      ASSERT_EQ(snapshot.Last(), snapshot.Length() - 1);
+      snapshots_checked++;
+    }
+  });
+  const auto result = PublishStream(ref, Iota(kElements),
+                                    {1'000, std::chrono::milliseconds(1)});
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(result.Length(), kElements);
+  EXPECT_EQ(to_vector(result), to_vector(Deque<int>::Empty().SnocRange(
+                                   std::views::iota(0, kElements))));
+  EXPECT_GT(snapshots_checked.load(), 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}